@@ -1,6 +1,7 @@
 #include "addingdialog.h"
 #include "ui_addingdialog.h"
 #include "core/discount.h"
+#include "pickermodel.h"
 #include <QMessageBox>
 #include <QRegularExpressionValidator>
 
@@ -191,28 +192,14 @@ void AddingDialog::populateComboBoxes(QMap<QString, QString> editData)
             if (!editData.isEmpty()) ui->comboDiscountAdd->setCurrentIndex(editData["discindex"].toInt());
         }
     } else if (currentMode == 3) { // Билет - заполняем пассажиров и тарифы
+        // Ленивые списки с поиском: строки форматируются только при отображении
         if (ui->comboVTypeAdd) {
-            ui->comboVTypeAdd->clear();
-            auto passengers = station->getAllPassengers();
-            for (size_t i = 0; i < passengers.size(); ++i) {
-                QString displayText = QString("%1 %2 (паспорт: %3)")
-                                          .arg(QString::fromStdString(passengers[i]->getLastName()))
-                                          .arg(QString::fromStdString(passengers[i]->getFirstName()))
-                                          .arg(passengers[i]->getPassport());
-                ui->comboVTypeAdd->addItem(displayText, static_cast<int>(i));
-            }
+            PickerModel::setupComboBox(ui->comboVTypeAdd, PickerModel::PASSENGERS, station);
             if (!editData.isEmpty()) ui->comboVTypeAdd->setCurrentIndex(editData["passindex"].toInt());
         }
 
         if (ui->comboDiscountAdd) {
-            ui->comboDiscountAdd->clear();
-            auto tariffs = station->getAllTariffs();
-            for (size_t i = 0; i < tariffs.size(); ++i) {
-                QString displayText = QString("%1 - %2 руб.")
-                                          .arg(QString::fromStdString(tariffs[i]->getName()))
-                                          .arg(tariffs[i]->calculatePrice(false), 0, 'f', 2);
-                ui->comboDiscountAdd->addItem(displayText, static_cast<int>(i));
-            }
+            PickerModel::setupComboBox(ui->comboDiscountAdd, PickerModel::TARIFFS, station);
             if (!editData.isEmpty()) ui->comboDiscountAdd->setCurrentIndex(editData["tariffindex"].toInt());
         }
     }
@@ -357,6 +344,13 @@ bool AddingDialog::collectTicketData(QVariantMap& data)
         return false;
     }
 
+    // Введенный, но не выбранный из подсказок текст сопоставляется с записями
+    if (PickerModel::resolveSelection(ui->comboVTypeAdd) < 0 ||
+        PickerModel::resolveSelection(ui->comboDiscountAdd) < 0) {
+        QMessageBox::warning(this, "Ошибка", "Выберите пассажира и тариф из списка");
+        return false;
+    }
+
     int passengerIndex = ui->comboVTypeAdd->currentData().toInt();
     int tariffIndex = ui->comboDiscountAdd->currentData().toInt();
 
@@ -375,7 +369,7 @@ bool AddingDialog::collectTicketData(QVariantMap& data)
     if (!isEdit){
         auto tickets = station->getTicketsByPassport(passenger->getPassport());
         for (const auto& ticket : tickets) {
-            if (ticket->getDestination() == tariff->getName()) {
+            if (ticket->getTariff() == tariff) {
                 QMessageBox::warning(this, "Ошибка", "У пассажира уже есть билет на это направление");
                 return false;
             }
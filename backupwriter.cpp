@@ -0,0 +1,96 @@
+#include "backupwriter.h"
+#include <QSaveFile>
+#include <QtConcurrent>
+#include <algorithm>
+
+BackupWriter::BackupWriter(const QString& fileName, SnapshotSource source, QObject* parent)
+    : QObject(parent)
+    , fileName(fileName)
+    , source(std::move(source))
+    , quietTimer(new QTimer(this))
+    , writeWatcher(new QFutureWatcher<bool>(this))
+{
+    quietTimer->setSingleShot(true);
+    connect(quietTimer, &QTimer::timeout, this, &BackupWriter::startWrite);
+    connect(writeWatcher, &QFutureWatcher<bool>::finished, this, &BackupWriter::onWriteFinished);
+}
+
+// Фоновая запись работает только со своей копией снимка, ее можно дождаться
+BackupWriter::~BackupWriter()
+{
+    writeWatcher->waitForFinished();
+}
+
+void BackupWriter::schedule()
+{
+    if (!quietTimer->isActive()) {
+        waitTimer.start();
+    }
+    qint64 remaining = MAX_WAIT_MS - waitTimer.elapsed();
+    quietTimer->start(static_cast<int>(std::clamp<qint64>(remaining, 0, QUIET_PERIOD_MS)));
+}
+
+void BackupWriter::start()
+{
+    quietTimer->stop();
+    startWrite();
+}
+
+void BackupWriter::cancel()
+{
+    quietTimer->stop();
+    pending = false;
+    writeWatcher->waitForFinished();
+}
+
+bool BackupWriter::flush()
+{
+    cancel();
+    bool ok = writeAtomically(fileName, source());
+    if (ok) {
+        emit written();
+    } else {
+        emit writeFailed();
+    }
+    return ok;
+}
+
+bool BackupWriter::writeAtomically(const QString& fileName, const std::string& content)
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    qint64 size = static_cast<qint64>(content.size());
+    if (file.write(content.data(), size) != size) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+void BackupWriter::startWrite()
+{
+    if (writeWatcher->isRunning()) {
+        pending = true;
+        return;
+    }
+
+    writeWatcher->setFuture(QtConcurrent::run(
+        [fileName = fileName, content = source()]() { return writeAtomically(fileName, content); }));
+}
+
+void BackupWriter::onWriteFinished()
+{
+    if (writeWatcher->result()) {
+        emit written();
+    } else {
+        emit writeFailed();
+    }
+
+    if (pending) {
+        pending = false;
+        startWrite();
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef BACKUPWRITER_H
+#define BACKUPWRITER_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <functional>
+#include <string>
+
+// Фоновая запись файла бэкапа.
+// schedule() откладывает запись до паузы в изменениях (QUIET_PERIOD_MS), так что
+// серия правок дает одну запись, но не позже MAX_WAIT_MS после первого запроса,
+// чтобы непрерывные правки не откладывали снимок. Снимок данных берется в GUI-потоке через source,
+// на диск он пишется в фоновом потоке: во временный файл, который затем атомарно
+// заменяет файл бэкапа (QSaveFile). Одновременно выполняется не больше одной записи.
+class BackupWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<std::string()> SnapshotSource;
+
+    static const int QUIET_PERIOD_MS = 1000;
+    static const int MAX_WAIT_MS = 10000;
+
+    BackupWriter(const QString& fileName, SnapshotSource source, QObject* parent = nullptr);
+    ~BackupWriter();
+
+    // Запись после паузы в изменениях
+    void schedule();
+
+    // Фоновая запись без ожидания паузы (после сброса или загрузки данных)
+    void start();
+
+    // Отмена отложенной записи; начатая запись дожидается завершения
+    void cancel();
+
+    // Немедленная запись текущих данных в GUI-потоке; только при завершении
+    // программы, когда фоновую запись уже некому дождаться
+    bool flush();
+
+    // Запись содержимого во временный файл с атомарной заменой fileName
+    static bool writeAtomically(const QString& fileName, const std::string& content);
+
+signals:
+    // Снимок записан и заменил файл бэкапа
+    void written();
+    void writeFailed();
+
+private:
+    QString fileName;
+    SnapshotSource source;
+    QTimer* quietTimer;
+    // Время с первого запроса записи, еще не начатой
+    QElapsedTimer waitTimer;
+    QFutureWatcher<bool>* writeWatcher;
+
+    // Запись запрошена, пока выполнялась предыдущая
+    bool pending = false;
+
+    void startWrite();
+    void onWriteFinished();
+};
+
+#endif // BACKUPWRITER_H
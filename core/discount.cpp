@@ -1,15 +1,17 @@
 #include "discount.h"
+#include "pricing.h"
 #include <algorithm>
+#include <cmath>
 
 NoDiscount::NoDiscount()
     : DiscountStrategy("Без скидки", 0.0f, "Полная стоимость") {}
 
-float NoDiscount::applyDiscount(float price) const {
+Money NoDiscount::applyDiscount(Money price) const {
     return price;
 }
 
-std::string NoDiscount::getDiscountName() const {
-    return "Без скидки";
+std::int32_t NoDiscount::getPriceShare() const {
+    return FULL_PRICE_SHARE;
 }
 
 float NoDiscount::getDiscountPercentage() const {
@@ -20,6 +22,11 @@ std::unique_ptr<DiscountStrategy> NoDiscount::clone() const {
     return std::make_unique<NoDiscount>();
 }
 
+DiscountHandle NoDiscount::shared() {
+    static const DiscountHandle instance = std::make_shared<const NoDiscount>();
+    return instance;
+}
+
 CustomDiscount::CustomDiscount(const DiscountInfo& discountInfo)
     : DiscountStrategy(discountInfo.name, discountInfo.percentage,
                        discountInfo.description) {}
@@ -28,12 +35,15 @@ CustomDiscount::CustomDiscount(const std::string& name, float percentage,
                                const std::string& description)
     : DiscountStrategy(name, percentage, description) {}
 
-float CustomDiscount::applyDiscount(float price) const {
-    DiscountInfo info = getDiscountInfo();
-    if (info.percentage < 0) return price;
+Money CustomDiscount::applyDiscount(Money price) const {
+    return Money(applyPriceShare(price.getKopecks(), getPriceShare()));
+}
+
+std::int32_t CustomDiscount::getPriceShare() const {
+    if (info.percentage < 0) return FULL_PRICE_SHARE;
     if (info.percentage > 100) return 0;
 
-    return price * (1.0f - info.percentage / 100.0f);
+    return FULL_PRICE_SHARE - static_cast<std::int32_t>(std::lround(info.percentage * 100.0f));
 }
 
 std::unique_ptr<DiscountStrategy> CustomDiscount::clone() const {
@@ -41,7 +51,22 @@ std::unique_ptr<DiscountStrategy> CustomDiscount::clone() const {
 }
 
 DiscountManager::DiscountManager() {
-    availableDiscounts.push_back(std::make_unique<NoDiscount>());
+    availableDiscounts.push_back(NoDiscount::shared());
+}
+
+void DiscountManager::setReplaceHandler(ReplaceHandler handler) {
+    replaceHandler = std::move(handler);
+}
+
+void DiscountManager::addChangeHandler(ChangeHandler handler) {
+    changeHandlers.push_back(std::move(handler));
+}
+
+void DiscountManager::notify(ChangeType type, size_t row) {
+    ChangeEvent event{ENTITY_DISCOUNT, type, row, 0};
+    for (const auto& handler : changeHandlers) {
+        handler(event);
+    }
 }
 
 std::vector<DiscountInfo> DiscountManager::getAllDiscounts() const {
@@ -52,22 +77,22 @@ std::vector<DiscountInfo> DiscountManager::getAllDiscounts() const {
     return result;
 }
 
-std::unique_ptr<DiscountStrategy> DiscountManager::getDiscountByName(const std::string& name) const {
+DiscountHandle DiscountManager::getDiscountByName(const std::string& name) const {
     auto it = std::find_if(availableDiscounts.begin(), availableDiscounts.end(),
-                           [&name](const std::unique_ptr<DiscountStrategy>& discount) {
+                           [&name](const DiscountHandle& discount) {
                                return discount->getDiscountInfo().name == name;
                            });
 
     if (it != availableDiscounts.end()) {
-        return (*it)->clone();
+        return *it;
     }
 
     return nullptr;
 }
 
-std::unique_ptr<DiscountStrategy> DiscountManager::getDiscountByIndex(size_t index) const {
+DiscountHandle DiscountManager::getDiscountByIndex(size_t index) const {
     if (index < availableDiscounts.size()) {
-        return availableDiscounts[index]->clone();
+        return availableDiscounts[index];
     }
 
     return nullptr;
@@ -91,8 +116,9 @@ bool DiscountManager::addCustomDiscount(const DiscountInfo& discountInfo) {
     }
 
     availableDiscounts.push_back(
-        std::make_unique<CustomDiscount>(discountInfo)
+        std::make_shared<const CustomDiscount>(discountInfo)
         );
+    notify(CHANGE_INSERTED, availableDiscounts.size() - 1);
 
     return true;
 }
@@ -103,12 +129,14 @@ bool DiscountManager::removeDiscount(const std::string& name) {
     }
 
     auto it = std::find_if(availableDiscounts.begin(), availableDiscounts.end(),
-                           [&name](const std::unique_ptr<DiscountStrategy>& discount) {
+                           [&name](const DiscountHandle& discount) {
                                return discount->getDiscountInfo().name == name;
                            });
 
     if (it != availableDiscounts.end()) {
+        size_t row = it - availableDiscounts.begin();
         availableDiscounts.erase(it);
+        notify(CHANGE_REMOVED, row);
         return true;
     }
 
@@ -129,7 +157,7 @@ bool DiscountManager::editDiscount(const std::string& oldName, const DiscountInf
     }
 
     auto it = std::find_if(availableDiscounts.begin(), availableDiscounts.end(),
-                           [&oldName](const std::unique_ptr<DiscountStrategy>& discount) {
+                           [&oldName](const DiscountHandle& discount) {
                                return discount->getDiscountInfo().name == oldName;
                            });
 
@@ -138,7 +166,14 @@ bool DiscountManager::editDiscount(const std::string& oldName, const DiscountInf
             return false;
         }
 
-        (*it)->setDiscountInfo(newInfo);
+        // Публикуем новую версию; тарифы со старой версией переводятся на нее подписчиком
+        DiscountHandle oldDiscount = *it;
+        *it = std::make_shared<const CustomDiscount>(newInfo);
+
+        if (replaceHandler) {
+            replaceHandler(oldDiscount.get(), *it);
+        }
+        notify(CHANGE_UPDATED, it - availableDiscounts.begin());
         return true;
     }
 
@@ -148,7 +183,7 @@ bool DiscountManager::editDiscount(const std::string& oldName, const DiscountInf
 
 bool DiscountManager::discountExists(const std::string& name) const {
     return std::any_of(availableDiscounts.begin(), availableDiscounts.end(),
-                       [&name](const std::unique_ptr<DiscountStrategy>& discount) {
+                       [&name](const DiscountHandle& discount) {
                            return discount->getDiscountInfo().name == name;
                        });
 }
@@ -160,9 +195,10 @@ size_t DiscountManager::getDiscountCount() const {
 void DiscountManager::clearCustomDiscounts() {
     availableDiscounts.erase(
         std::remove_if(availableDiscounts.begin(), availableDiscounts.end(),
-                       [](const std::unique_ptr<DiscountStrategy>& discount) {
+                       [](const DiscountHandle& discount) {
                            return discount->getDiscountInfo().name != "Без скидки";
                        }),
         availableDiscounts.end()
         );
+    notify(CHANGE_RESET, 0);
 }
@@ -4,7 +4,9 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
 #include "types.h"
+#include "money.h"
 
 class DiscountStrategy {
 protected:
@@ -18,13 +20,17 @@ public:
     virtual ~DiscountStrategy() = default;
 
     // Основной метод применения скидки
-    virtual float applyDiscount(float price) const = 0;
+    virtual Money applyDiscount(Money price) const = 0;
+
+    // Доля цены, остающаяся после скидки, в сотых долях процента (10000 - без скидки),
+    // для пакетного расчета цен
+    virtual std::int32_t getPriceShare() const = 0;
 
     // Получение информации о скидке
-    virtual DiscountInfo getDiscountInfo() const { return info; }
-    virtual std::string getDiscountName() const { return info.name; }
+    virtual const DiscountInfo& getDiscountInfo() const { return info; }
+    virtual const std::string& getDiscountName() const { return info.name; }
     virtual float getDiscountPercentage() const { return info.percentage; }
-    virtual std::string getDiscountDescription() const { return info.description; }
+    virtual const std::string& getDiscountDescription() const { return info.description; }
 
     // Установка информации о скидке
     virtual void setDiscountInfo(const DiscountInfo& newInfo) { info = newInfo; }
@@ -33,13 +39,20 @@ public:
     virtual std::unique_ptr<DiscountStrategy> clone() const = 0;
 };
 
+// Общая неизменяемая скидка из реестра. Тарифы ссылаются на одну запись реестра,
+// копирование дескриптора не выделяет память
+typedef std::shared_ptr<const DiscountStrategy> DiscountHandle;
+
 // Базовая скидка "Без скидки"
 class NoDiscount : public DiscountStrategy {
 public:
     NoDiscount();
 
-    float applyDiscount(float price) const override;
-    std::string getDiscountName() const override;
+    // Общий экземпляр для тарифов без скидки
+    static DiscountHandle shared();
+
+    Money applyDiscount(Money price) const override;
+    std::int32_t getPriceShare() const override;
     float getDiscountPercentage() const override;
     std::unique_ptr<DiscountStrategy> clone() const override;
 };
@@ -51,26 +64,43 @@ public:
     CustomDiscount(const std::string& name, float percentage,
                    const std::string& description = "");
 
-    float applyDiscount(float price) const override;
+    Money applyDiscount(Money price) const override;
+    std::int32_t getPriceShare() const override;
     std::unique_ptr<DiscountStrategy> clone() const override;
 };
 
-// Класс для управления всеми доступными скидками
+// Класс для управления всеми доступными скидками.
+// Записи реестра неизменяемы: редактирование публикует новую версию скидки
+// и сообщает о замене подписчику, который переводит на нее зависимые тарифы
 class DiscountManager {
+public:
+    typedef std::function<void(const DiscountStrategy* oldDiscount,
+                               const DiscountHandle& newDiscount)> ReplaceHandler;
+
 private:
-    std::vector<std::unique_ptr<DiscountStrategy>> availableDiscounts;
+    std::vector<DiscountHandle> availableDiscounts;
+    ReplaceHandler replaceHandler;
+    std::vector<ChangeHandler> changeHandlers;
+
+    void notify(ChangeType type, size_t row);
 
 public:
     DiscountManager();
 
+    // Подписка на публикацию новых версий скидок
+    void setReplaceHandler(ReplaceHandler handler);
+
+    // Подписка на добавление, изменение и удаление скидок реестра
+    void addChangeHandler(ChangeHandler handler);
+
     // Получение всех доступных скидок
     std::vector<DiscountInfo> getAllDiscounts() const;
 
     // Получение скидки по имени
-    std::unique_ptr<DiscountStrategy> getDiscountByName(const std::string& name) const;
+    DiscountHandle getDiscountByName(const std::string& name) const;
 
     // Получение скидки по индексу
-    std::unique_ptr<DiscountStrategy> getDiscountByIndex(size_t index) const;
+    DiscountHandle getDiscountByIndex(size_t index) const;
 
     // Добавление новой пользовательской скидки
     bool addCustomDiscount(const DiscountInfo& discountInfo);
@@ -0,0 +1,29 @@
+#ifndef ENTITYVIEW_H
+#define ENTITYVIEW_H
+
+#include <cstddef>
+
+// Легковесное представление непрерывного массива указателей на объекты станции.
+// Ничего не копирует и не выделяет память; действительно до следующего изменения
+// соответствующего контейнера станции (добавления или удаления записей).
+template <typename T>
+class EntityView {
+public:
+    typedef T* const* iterator;
+
+    EntityView(iterator first, iterator last) : first(first), last(last) {}
+
+    iterator begin() const { return first; }
+    iterator end() const { return last; }
+
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+
+    T* operator[](size_t index) const { return first[index]; }
+
+private:
+    iterator first;
+    iterator last;
+};
+
+#endif // ENTITYVIEW_H
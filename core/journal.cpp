@@ -0,0 +1,406 @@
+#include "journal.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Контрольная сумма строки записи (FNV-1a), пишется в шестнадцатеричном виде
+std::string checksum(const std::string& text)
+{
+    std::uint32_t hash = 2166136261u;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    char buffer[9];
+    std::snprintf(buffer, sizeof(buffer), "%08x", hash);
+    return buffer;
+}
+
+// Данные файла передаются на диск, а не только в буфер ОС
+bool syncFile(std::FILE* file)
+{
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+} // namespace
+
+Journal::Journal(Station* station, DiscountManager* discountManager)
+    : station(station)
+    , discountManager(discountManager)
+{
+}
+
+Journal::~Journal()
+{
+    close();
+}
+
+// Если файл оканчивается оборванной строкой, новые записи начинаются с новой строки
+bool Journal::open(const std::string& filename)
+{
+    close();
+    this->filename = filename;
+    file = std::fopen(filename.c_str(), "a+b");
+    if (!file) {
+        return false;
+    }
+
+    if (std::fseek(file, -1, SEEK_END) == 0 && std::fgetc(file) != '\n') {
+        std::fseek(file, 0, SEEK_END);
+        std::fputc('\n', file);
+        syncFile(file);
+    }
+
+    stopping = false;
+    writer = std::thread(&Journal::writeLoop, this);
+    return true;
+}
+
+// Остаток буфера дописывается фоновым потоком до его завершения
+void Journal::close()
+{
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+
+    if (file) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+// Строки забираются из буфера под fileMutex, поэтому rewrite() не может
+// вклиниться между забором пачки и ее записью
+void Journal::writeLoop()
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !buffer.empty(); });
+            if (stopping && buffer.empty()) {
+                return;
+            }
+        }
+
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        std::string batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch.swap(buffer);
+        }
+        if (!batch.empty() && file) {
+            std::fputs(batch.c_str(), file);
+            syncFile(file);
+        }
+    }
+}
+
+bool Journal::isOpen() const
+{
+    return file != nullptr;
+}
+
+// Поля записи в порядке файла сохранения
+std::string Journal::encode(const ChangeEvent& event) const
+{
+    std::ostringstream line;
+    const char ops[] = {'+', '=', '-'};
+    int row = static_cast<int>(event.row);
+
+    switch (event.entity) {
+    case ENTITY_PASSENGER: {
+        line << "P|" << ops[event.type] << "|" << row;
+        if (event.type == CHANGE_REMOVED) break;
+        const Passenger* p = station->getPassengerAt(row);
+        if (!p) return "";
+        line << "|" << p->getPassport() << "|" << p->getFirstName() << "|" << p->getLastName();
+        break;
+    }
+    case ENTITY_TARIFF: {
+        line << "T|" << ops[event.type] << "|" << row;
+        if (event.type == CHANGE_REMOVED) break;
+        const Tariff* t = station->getTariffAt(row);
+        if (!t) return "";
+        line << "|" << t->getName() << "|" << t->getBasePrice().toString() << "|"
+             << static_cast<int>(t->getVType()) << "|" << t->getDiscountInfo().name;
+        break;
+    }
+    case ENTITY_TICKET: {
+        line << "K|" << ops[event.type] << "|" << row;
+        if (event.type == CHANGE_REMOVED) break;
+        const Ticket* ticket = station->getTicketAt(row);
+        if (!ticket) return "";
+        line << "|" << ticket->getPassportNumber() << "|" << ticket->getDestination();
+        break;
+    }
+    case ENTITY_DISCOUNT: {
+        line << "D|" << ops[event.type] << "|" << row;
+        if (event.type == CHANGE_REMOVED) break;
+        DiscountHandle d = discountManager->getDiscountByIndex(event.row);
+        if (!d) return "";
+        const DiscountInfo& info = d->getDiscountInfo();
+        line << "|" << info.name << "|" << info.description << "|" << info.percentage;
+        break;
+    }
+    }
+    return line.str();
+}
+
+void Journal::record(const ChangeEvent& event)
+{
+    if (!file || replaying) return;
+
+    // Номер сброса не записывается в файл, но снимки, взятые до сброса,
+    // получают меньший номер и журнал не очищают
+    if (event.type == CHANGE_RESET) {
+        resetSeq = ++lastSeq;
+        snapshotNeeded = true;
+        lines.clear();
+        return;
+    }
+
+    std::string line = encode(event);
+    if (line.empty()) return;
+
+    line = std::to_string(++lastSeq) + "|" + line;
+    line += "|" + checksum(line) + "\n";
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer += line;
+    }
+    wake.notify_one();
+    lines.emplace_back(lastSeq, std::move(line));
+    ++recordCount;
+}
+
+// Применение одной записи; позиции совпадают с порядком записей в момент записи
+bool Journal::apply(char kind, char op, size_t row, const std::vector<std::string>& fields)
+{
+    int index = static_cast<int>(row);
+
+    switch (kind) {
+    case 'P': {
+        if (op == '-') {
+            Passenger* p = station->getPassengerAt(index);
+            return p && station->removePassenger(p->getPassport());
+        }
+        if (fields.size() < 3) return false;
+        int passport = std::stoi(fields[0]);
+        if (op == '+') {
+            if (station->findPassengerByPassport(passport)) return false;
+            return station->addPassenger(passport, fields[1], fields[2]) != nullptr;
+        }
+        Passenger* p = station->getPassengerAt(index);
+        if (!p) return false;
+        if (p->getPassport() != passport) p->setPassport(passport);
+        if (p->getFirstName() != fields[1]) p->setFName(fields[1]);
+        if (p->getLastName() != fields[2]) p->setLName(fields[2]);
+        return true;
+    }
+    case 'T': {
+        if (op == '-') {
+            Tariff* t = station->getTariffAt(index);
+            return t && station->removeTariff(t->getName());
+        }
+        if (fields.size() < 4) return false;
+        Money price;
+        if (!Money::parse(fields[1], price)) return false;
+        int typeNumber = std::stoi(fields[2]);
+        if (!isValidVagonType(typeNumber)) return false;
+        VagonType type = static_cast<VagonType>(typeNumber);
+        DiscountHandle discount = discountManager->getDiscountByName(fields[3]);
+        if (op == '+') {
+            if (station->getTariffByName(fields[0])) return false;
+            if (!discount) discount = NoDiscount::shared();
+            return station->addTariff(fields[0], price, type, std::move(discount)) != nullptr;
+        }
+        Tariff* t = station->getTariffAt(index);
+        if (!t) return false;
+        if (t->getName() != fields[0]) t->setName(fields[0]);
+        if (t->getBasePrice() != price) t->setBasePrice(price);
+        if (t->getVType() != type) t->setVType(type);
+        // Скидка, переименованная следующей записью, еще не существует -
+        // тариф переведет на нее сама запись скидки
+        if (discount && t->getDiscount() != discount.get()) t->setDiscount(std::move(discount));
+        return true;
+    }
+    case 'K': {
+        if (op == '-') {
+            Ticket* ticket = station->getTicketAt(index);
+            return ticket && station->removeTicket(ticket->getId());
+        }
+        if (fields.size() < 2) return false;
+        Passenger* passenger = station->findPassengerByPassport(std::stoi(fields[0]));
+        Tariff* tariff = station->getTariffByName(fields[1]);
+        if (!passenger || !tariff) return false;
+        if (op == '+') {
+            station->buyTicket(passenger, tariff);
+            return true;
+        }
+        Ticket* ticket = station->getTicketAt(index);
+        if (!ticket) return false;
+        if (ticket->getPassenger() != passenger) ticket->setPassenger(passenger);
+        if (ticket->getTariff() != tariff) ticket->setTariff(tariff);
+        return true;
+    }
+    case 'D': {
+        DiscountHandle current = discountManager->getDiscountByIndex(row);
+        if (op == '-') {
+            return current && discountManager->removeDiscount(current->getDiscountInfo().name);
+        }
+        if (fields.size() < 3) return false;
+        DiscountInfo info(fields[0], std::stof(fields[2]), fields[1]);
+        if (op == '+') {
+            return discountManager->addCustomDiscount(info);
+        }
+        return current && discountManager->editDiscount(current->getDiscountInfo().name, info);
+    }
+    }
+    return false;
+}
+
+size_t Journal::replay(const std::string& filename, std::uint64_t afterSeq)
+{
+    if (lastSeq < afterSeq) lastSeq = afterSeq;
+
+    std::ifstream in(filename);
+    if (!in.is_open()) {
+        return 0;
+    }
+
+    // Изменения при воспроизведении не записываются повторно
+    replaying = true;
+
+    size_t applied = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        // Строка без перевода строки в конце файла оборвана при сбое
+        if (in.eof()) break;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        // Оборванная или поврежденная запись пропускается
+        size_t separator = line.rfind('|');
+        if (separator == std::string::npos
+            || line.compare(separator + 1, std::string::npos, checksum(line.substr(0, separator))) != 0) {
+            continue;
+        }
+        std::string stored = line + "\n";
+        line.resize(separator);
+
+        std::istringstream iss(line);
+        std::string token;
+        std::vector<std::string> tokens;
+        while (std::getline(iss, token, '|')) {
+            tokens.push_back(token);
+        }
+
+        if (tokens.size() < 4 || tokens[1].size() != 1 || tokens[2].size() != 1) continue;
+
+        try {
+            std::uint64_t seq = std::stoull(tokens[0]);
+            if (seq <= afterSeq) continue;
+
+            size_t row = static_cast<size_t>(std::stoul(tokens[3]));
+            std::vector<std::string> fields(tokens.begin() + 4, tokens.end());
+            if (apply(tokens[1][0], tokens[2][0], row, fields)) {
+                ++applied;
+            }
+            if (lastSeq < seq) lastSeq = seq;
+            lines.emplace_back(seq, std::move(stored));
+            ++recordCount;
+        } catch (...) {
+            // Пропускаем некорректные записи
+        }
+    }
+
+    replaying = false;
+    return applied;
+}
+
+std::uint64_t Journal::getLastSeq() const
+{
+    return lastSeq;
+}
+
+size_t Journal::getRecordCount() const
+{
+    return recordCount;
+}
+
+bool Journal::isSnapshotNeeded() const
+{
+    return snapshotNeeded;
+}
+
+// Записи, сделанные пока снимок писался, в него не вошли и остаются в журнале
+void Journal::snapshotWritten(std::uint64_t seq)
+{
+    if (seq < resetSeq) {
+        return;
+    }
+
+    snapshotNeeded = false;
+    auto newer = std::find_if(lines.begin(), lines.end(),
+                              [seq](const auto& entry) { return entry.first > seq; });
+    lines.erase(lines.begin(), newer);
+    recordCount = lines.size();
+    if (file) {
+        rewrite();
+    }
+}
+
+// Новый файл журнала пишется рядом и заменяет старый; при ошибке остается
+// старый файл, в котором есть все записи нового
+bool Journal::rewrite()
+{
+    // Строки буфера уже есть в lines и попадут в новый файл
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer.clear();
+    }
+
+    std::string tempName = filename + ".tmp";
+    std::FILE* temp = std::fopen(tempName.c_str(), "wb");
+    if (!temp) {
+        return false;
+    }
+    bool ok = true;
+    for (const auto& entry : lines) {
+        ok = ok && std::fputs(entry.second.c_str(), temp) >= 0;
+    }
+    ok = syncFile(temp) && ok;
+    std::fclose(temp);
+
+    std::fclose(file);
+#ifdef _WIN32
+    // rename() в Windows не заменяет существующий файл
+    if (ok) std::remove(filename.c_str());
+#endif
+    ok = ok && std::rename(tempName.c_str(), filename.c_str()) == 0;
+    if (!ok) {
+        std::remove(tempName.c_str());
+    }
+    file = std::fopen(filename.c_str(), "a+b");
+    return ok;
+}
@@ -0,0 +1,95 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "station.h"
+#include "discount.h"
+#include <cstdint>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Журнал операций, дописываемый к снимку данных (файлу сохранения).
+// Каждое уведомление Station и DiscountManager записывается одной строкой
+//   номер|вид|операция|позиция|поля записи|контрольная сумма
+// (вид: P - пассажир, T - тариф, K - билет, D - скидка; операция: + добавление,
+// = изменение, - удаление), поэтому сохранение одной операции не зависит от
+// объема данных. record() только добавляет строку в буфер; фоновый поток
+// дописывает накопленные строки в файл пачкой с одной синхронизацией с диском
+// на пачку, поэтому серия уведомлений не ждет диска. close() дописывает остаток.
+// Строка без перевода строки или с неверной контрольной суммой (оборванная
+// при сбое) при восстановлении пропускается. Номера записей сквозные; снимок
+// хранит номер последней вошедшей в него записи, и при восстановлении
+// применяются только более новые записи.
+// Сброс данных (загрузка файла, очистка) журналом не выражается: после него
+// нужен новый снимок. После записи снимка журнал переписывается: в нем остаются
+// только записи новее снимка, сделанные, пока снимок писался.
+class Journal {
+private:
+    Station* station;
+    DiscountManager* discountManager;
+
+    std::string filename;
+    std::FILE* file = nullptr;
+
+    // Фоновая дозапись: буфер строк защищен mutex, файл - fileMutex
+    std::thread writer;
+    std::mutex mutex;
+    std::mutex fileMutex;
+    std::condition_variable wake;
+    std::string buffer;
+    bool stopping = false;
+
+    void writeLoop();
+
+    std::uint64_t lastSeq = 0;
+    size_t recordCount = 0;
+    // Номер последнего сброса: более старые снимки журнал не очищают
+    std::uint64_t resetSeq = 0;
+    bool snapshotNeeded = false;
+    bool replaying = false;
+
+    // Строки файла новее последнего записанного снимка (с номерами)
+    std::vector<std::pair<std::uint64_t, std::string>> lines;
+
+    bool rewrite();
+
+    std::string encode(const ChangeEvent& event) const;
+    bool apply(char kind, char op, size_t row, const std::vector<std::string>& fields);
+
+public:
+    Journal(Station* station, DiscountManager* discountManager);
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Открытие файла журнала для дозаписи
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const;
+
+    // Запись операции по уведомлению (если журнал открыт и не идет воспроизведение)
+    void record(const ChangeEvent& event);
+
+    // Применение записей файла с номером больше afterSeq к текущим данным
+    // (загруженному снимку); возвращает число примененных записей
+    size_t replay(const std::string& filename, std::uint64_t afterSeq);
+
+    // Номер последней записи (для сохранения в снимке)
+    std::uint64_t getLastSeq() const;
+
+    // Число записей с последнего снимка
+    size_t getRecordCount() const;
+
+    // Был сброс данных, после которого журнал неприменим к старому снимку
+    bool isSnapshotNeeded() const;
+
+    // Снимок с номером seq записан: в журнале остаются только более новые записи
+    void snapshotWritten(std::uint64_t seq);
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,87 @@
+#include "ledger.h"
+
+void RevenueTotals::merge(const RevenueTotals& other)
+{
+    revenue += other.revenue;
+    fullRevenue += other.fullRevenue;
+    ticketCount += other.ticketCount;
+}
+
+void TicketLedger::append(std::uint32_t passengerKey, std::uint32_t tariffKey, Money price, Money fullPrice)
+{
+    passengerKeys.push_back(passengerKey);
+    tariffKeys.push_back(tariffKey);
+    prices.push_back(price.getKopecks());
+    fullPrices.push_back(fullPrice.getKopecks());
+}
+
+// Удаление строки с переносом последней строки на ее место
+void TicketLedger::removeAt(size_t row)
+{
+    size_t last = size() - 1;
+    if (row != last) {
+        passengerKeys[row] = passengerKeys[last];
+        tariffKeys[row] = tariffKeys[last];
+        prices[row] = prices[last];
+        fullPrices[row] = fullPrices[last];
+    }
+
+    passengerKeys.pop_back();
+    tariffKeys.pop_back();
+    prices.pop_back();
+    fullPrices.pop_back();
+}
+
+void TicketLedger::setRow(size_t row, std::uint32_t passengerKey, std::uint32_t tariffKey, Money price, Money fullPrice)
+{
+    passengerKeys[row] = passengerKey;
+    tariffKeys[row] = tariffKey;
+    setPrice(row, price, fullPrice);
+}
+
+void TicketLedger::setPrice(size_t row, Money price, Money fullPrice)
+{
+    prices[row] = price.getKopecks();
+    fullPrices[row] = fullPrice.getKopecks();
+}
+
+void TicketLedger::clear()
+{
+    passengerKeys.clear();
+    tariffKeys.clear();
+    prices.clear();
+    fullPrices.clear();
+}
+
+size_t TicketLedger::size() const
+{
+    return prices.size();
+}
+
+const std::vector<std::uint32_t>& TicketLedger::getPassengerKeys() const
+{
+    return passengerKeys;
+}
+
+const std::vector<std::uint32_t>& TicketLedger::getTariffKeys() const
+{
+    return tariffKeys;
+}
+
+const std::vector<std::int64_t>& TicketLedger::getPrices(bool withoutDiscounts) const
+{
+    return withoutDiscounts ? fullPrices : prices;
+}
+
+// Итоги по каждому ключу тарифа за один проход по колонкам
+std::vector<RevenueTotals> TicketLedger::totalsByTariff(size_t tariffKeyCount) const
+{
+    std::vector<RevenueTotals> result(tariffKeyCount);
+    for (size_t i = 0; i < tariffKeys.size(); ++i) {
+        RevenueTotals& totals = result[tariffKeys[i]];
+        totals.revenue += Money(prices[i]);
+        totals.fullRevenue += Money(fullPrices[i]);
+        ++totals.ticketCount;
+    }
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef LEDGER_H
+#define LEDGER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "money.h"
+
+// Итоги по группе билетов
+struct RevenueTotals {
+    Money revenue;            // со скидками
+    Money fullRevenue;        // без скидок
+    std::uint64_t ticketCount = 0;
+
+    Money getDiscountLoss() const { return fullRevenue - revenue; }
+    void merge(const RevenueTotals& other);
+};
+
+// Колоночная (struct-of-arrays) книга продаж.
+// Строка i соответствует i-му билету в плотном массиве станции: при удалении
+// последняя строка переносится на место удаленной, как и в SlotMap.
+// Пассажиры и тарифы представлены числовыми ключами, которые выдает Station.
+class TicketLedger {
+private:
+    std::vector<std::uint32_t> passengerKeys;
+    std::vector<std::uint32_t> tariffKeys;
+    std::vector<std::int64_t> prices;      // цена со скидкой, копейки
+    std::vector<std::int64_t> fullPrices;  // цена без скидки, копейки
+
+public:
+    void append(std::uint32_t passengerKey, std::uint32_t tariffKey, Money price, Money fullPrice);
+    void removeAt(size_t row);
+    void setRow(size_t row, std::uint32_t passengerKey, std::uint32_t tariffKey, Money price, Money fullPrice);
+    void setPrice(size_t row, Money price, Money fullPrice);
+    void clear();
+
+    size_t size() const;
+
+    // Доступ к колонкам
+    const std::vector<std::uint32_t>& getPassengerKeys() const;
+    const std::vector<std::uint32_t>& getTariffKeys() const;
+    const std::vector<std::int64_t>& getPrices(bool withoutDiscounts) const;
+
+    // Выручка, выручка без скидок и число билетов по ключам тарифов за один проход
+    // (точные целочисленные суммы)
+    std::vector<RevenueTotals> totalsByTariff(size_t tariffKeyCount) const;
+};
+
+#endif // LEDGER_H
@@ -0,0 +1,71 @@
+#include "money.h"
+#include <cmath>
+
+Money Money::fromRubles(double rubles)
+{
+    return Money(static_cast<std::int64_t>(std::llround(rubles * 100.0)));
+}
+
+bool Money::parse(const std::string& text, Money& result)
+{
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) {
+        negative = text[pos] == '-';
+        ++pos;
+    }
+
+    std::int64_t rubles = 0;
+    size_t digits = 0;
+    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+        rubles = rubles * 10 + (text[pos] - '0');
+        ++pos;
+        ++digits;
+    }
+
+    std::int64_t fraction = 0;
+    if (pos < text.size() && text[pos] == '.') {
+        ++pos;
+        int scale = 0;
+        bool roundUp = false;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+            if (scale < 2) {
+                fraction = fraction * 10 + (text[pos] - '0');
+                ++scale;
+            } else if (scale == 2) {
+                roundUp = text[pos] >= '5';
+                ++scale;
+            }
+            ++pos;
+            ++digits;
+        }
+        while (scale < 2) {
+            fraction *= 10;
+            ++scale;
+        }
+        if (roundUp) {
+            ++fraction;
+        }
+    }
+
+    if (digits == 0 || pos != text.size()) {
+        return false;
+    }
+
+    std::int64_t value = rubles * 100 + fraction;
+    result = Money(negative ? -value : value);
+    return true;
+}
+
+std::string Money::toString() const
+{
+    std::int64_t absolute = kopecks < 0 ? -kopecks : kopecks;
+    std::int64_t fraction = absolute % 100;
+
+    std::string text = std::to_string(absolute / 100);
+    text += '.';
+    text += static_cast<char>('0' + fraction / 10);
+    text += static_cast<char>('0' + fraction % 10);
+
+    return kopecks < 0 ? "-" + text : text;
+}
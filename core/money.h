@@ -0,0 +1,46 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cstdint>
+#include <string>
+
+// Денежная сумма в целых копейках.
+// Сложение и умножение на количество точные, поэтому суммы не зависят от порядка
+// суммирования (в т.ч. при разбиении по потокам)
+class Money {
+private:
+    std::int64_t kopecks;
+
+public:
+    constexpr Money() : kopecks(0) {}
+    constexpr explicit Money(std::int64_t kopecks) : kopecks(kopecks) {}
+
+    static Money fromRubles(double rubles);
+
+    // Разбор десятичной записи в рублях ("1500", "99.9", "123.45").
+    // Знаки после второго округляются. Возвращает false для некорректной строки
+    static bool parse(const std::string& text, Money& result);
+
+    std::int64_t getKopecks() const { return kopecks; }
+    double toRubles() const { return static_cast<double>(kopecks) / 100.0; }
+
+    // Запись в рублях с двумя знаками после точки ("123.45")
+    std::string toString() const;
+
+    Money& operator+=(Money other) { kopecks += other.kopecks; return *this; }
+    Money& operator-=(Money other) { kopecks -= other.kopecks; return *this; }
+
+    friend Money operator+(Money a, Money b) { return Money(a.kopecks + b.kopecks); }
+    friend Money operator-(Money a, Money b) { return Money(a.kopecks - b.kopecks); }
+    friend Money operator-(Money a) { return Money(-a.kopecks); }
+    friend Money operator*(Money a, std::int64_t count) { return Money(a.kopecks * count); }
+
+    friend bool operator==(Money a, Money b) { return a.kopecks == b.kopecks; }
+    friend bool operator!=(Money a, Money b) { return a.kopecks != b.kopecks; }
+    friend bool operator<(Money a, Money b) { return a.kopecks < b.kopecks; }
+    friend bool operator<=(Money a, Money b) { return a.kopecks <= b.kopecks; }
+    friend bool operator>(Money a, Money b) { return a.kopecks > b.kopecks; }
+    friend bool operator>=(Money a, Money b) { return a.kopecks >= b.kopecks; }
+};
+
+#endif // MONEY_H
@@ -0,0 +1,177 @@
+#include "nameindex.h"
+#include <algorithm>
+
+namespace {
+
+// Нижний регистр для латиницы и кириллицы, ё приравнивается к е
+char32_t foldChar(char32_t c)
+{
+    if (c >= U'A' && c <= U'Z') return c + 0x20;
+    if (c >= 0x0410 && c <= 0x042F) return c + 0x20;  // А-Я
+    if (c >= 0x0400 && c <= 0x040F) c += 0x50;         // Ѐ-Џ, в т.ч. Ё
+    if (c == 0x0451) return 0x0435;                    // ё -> е
+    return c;
+}
+
+} // namespace
+
+std::u32string NameIndex::fold(std::string_view text)
+{
+    std::u32string result;
+    result.reserve(text.size());
+
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        char32_t c = lead;
+        size_t length = 1;
+
+        if ((lead & 0xE0) == 0xC0) { c = lead & 0x1F; length = 2; }
+        else if ((lead & 0xF0) == 0xE0) { c = lead & 0x0F; length = 3; }
+        else if ((lead & 0xF8) == 0xF0) { c = lead & 0x07; length = 4; }
+
+        // Некорректная последовательность берется побайтно
+        bool valid = i + length <= text.size();
+        for (size_t k = 1; valid && k < length; ++k) {
+            unsigned char next = static_cast<unsigned char>(text[i + k]);
+            valid = (next & 0xC0) == 0x80;
+            c = (c << 6) | (next & 0x3F);
+        }
+        if (!valid) {
+            c = lead;
+            length = 1;
+        }
+
+        result.push_back(foldChar(c));
+        i += length;
+    }
+    return result;
+}
+
+// Различные триграммы строки
+std::vector<std::uint64_t> NameIndex::trigramsOf(const std::u32string& text)
+{
+    std::vector<std::uint64_t> result;
+    for (size_t i = 0; i + 3 <= text.size(); ++i) {
+        result.push_back((static_cast<std::uint64_t>(text[i]) << 42) |
+                         (static_cast<std::uint64_t>(text[i + 1]) << 21) |
+                         static_cast<std::uint64_t>(text[i + 2]));
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+void NameIndex::insert(std::uint32_t key, std::string_view lastName, std::string_view firstName)
+{
+    std::u32string name = fold(lastName);
+    name.push_back(U' ');
+    name += fold(firstName);
+    insertFolded(key, std::move(name));
+}
+
+void NameIndex::insert(std::uint32_t key, std::string_view text)
+{
+    insertFolded(key, fold(text));
+}
+
+void NameIndex::insertFolded(std::uint32_t key, std::u32string name)
+{
+    if (key < names.size() && !names[key].empty()) {
+        erase(key);
+    }
+    if (key >= names.size()) {
+        names.resize(key + 1);
+    }
+    if (name.empty()) {
+        return;
+    }
+
+    for (std::uint64_t trigram : trigramsOf(name)) {
+        std::vector<std::uint32_t>& keys = trigrams[trigram];
+        if (keys.empty() || keys.back() < key) {
+            keys.push_back(key);
+        } else {
+            keys.insert(std::lower_bound(keys.begin(), keys.end(), key), key);
+        }
+    }
+    sorted.emplace(name, key);
+    names[key] = std::move(name);
+}
+
+void NameIndex::erase(std::uint32_t key)
+{
+    if (key >= names.size() || names[key].empty()) {
+        return;
+    }
+
+    std::u32string& name = names[key];
+    for (std::uint64_t trigram : trigramsOf(name)) {
+        auto it = trigrams.find(trigram);
+        std::vector<std::uint32_t>& keys = it->second;
+        keys.erase(std::lower_bound(keys.begin(), keys.end(), key));
+        if (keys.empty()) trigrams.erase(it);
+    }
+    sorted.erase({name, key});
+    name.clear();
+}
+
+void NameIndex::clear()
+{
+    names.clear();
+    sorted.clear();
+    trigrams.clear();
+}
+
+// Поиск по началу строки: O(log n + k)
+std::vector<std::uint32_t> NameIndex::findPrefix(std::string_view prefix, size_t limit) const
+{
+    std::vector<std::uint32_t> result;
+    std::u32string folded = fold(prefix);
+
+    for (auto it = sorted.lower_bound({folded, 0});
+         it != sorted.end() && result.size() < limit; ++it) {
+        if (it->first.compare(0, folded.size(), folded) != 0) {
+            break;
+        }
+        result.push_back(it->second);
+    }
+    return result;
+}
+
+// Поиск подстроки по самому короткому списку триграмм запроса.
+// Запросы короче трех символов проверяются по всем записям
+std::vector<std::uint32_t> NameIndex::findSubstring(std::string_view text, size_t limit) const
+{
+    std::vector<std::uint32_t> result;
+    std::u32string folded = fold(text);
+
+    if (folded.size() < 3) {
+        for (size_t key = 0; key < names.size() && result.size() < limit; ++key) {
+            if (!names[key].empty() && names[key].find(folded) != std::u32string::npos) {
+                result.push_back(static_cast<std::uint32_t>(key));
+            }
+        }
+        return result;
+    }
+
+    const std::vector<std::uint32_t>* candidates = nullptr;
+    for (std::uint64_t trigram : trigramsOf(folded)) {
+        auto it = trigrams.find(trigram);
+        if (it == trigrams.end()) {
+            return result;
+        }
+        if (!candidates || it->second.size() < candidates->size()) {
+            candidates = &it->second;
+        }
+    }
+
+    // Списки упорядочены по ключам, поэтому проверка останавливается на limit
+    for (std::uint32_t key : *candidates) {
+        if (result.size() >= limit) break;
+        if (names[key].find(folded) != std::u32string::npos) {
+            result.push_back(key);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,45 @@
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Поисковый индекс по строке "Фамилия Имя" (или по одной строке, например названию).
+// Строки хранятся в свернутом виде (нижний регистр латиницы и кириллицы, ё = е).
+// Поиск по началу строки идет по упорядоченному множеству, поиск подстроки - по
+// спискам триграмм: берется самый короткий список из триграмм запроса, и его
+// кандидаты проверяются сравнением строк. Записи идентифицируются числовыми ключами;
+// списки триграмм упорядочены по ключам, удаление из них - двоичным поиском.
+class NameIndex {
+private:
+    std::vector<std::u32string> names;  // свернутая строка по ключу, пустая - нет записи
+    std::set<std::pair<std::u32string, std::uint32_t>> sorted;
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> trigrams;
+
+    static std::vector<std::uint64_t> trigramsOf(const std::u32string& text);
+
+    void insertFolded(std::uint32_t key, std::u32string name);
+
+public:
+    // Свертка строки UTF-8 для сравнения без учета регистра
+    static std::u32string fold(std::string_view text);
+
+    void insert(std::uint32_t key, std::string_view lastName, std::string_view firstName);
+    void insert(std::uint32_t key, std::string_view text);
+    void erase(std::uint32_t key);
+    void clear();
+
+    // Ключи записей, начинающихся с prefix, в алфавитном порядке
+    std::vector<std::uint32_t> findPrefix(std::string_view prefix, size_t limit) const;
+
+    // Ключи записей, содержащих text, в порядке возрастания ключей
+    std::vector<std::uint32_t> findSubstring(std::string_view text, size_t limit) const;
+};
+
+#endif // NAMEINDEX_H
@@ -0,0 +1,99 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Пул объектов одного типа.
+// Память выделяется крупными блоками по BlockSize объектов, освобожденные ячейки
+// переиспользуются через список свободных. Объекты никогда не перемещаются, поэтому
+// указатели на них остаются действительными до destroy() или clear().
+template <typename T, size_t BlockSize = 1024>
+class ObjectPool {
+public:
+    ObjectPool() = default;
+    ~ObjectPool() { clear(); }
+
+    // Запрещаем копирование
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args)
+    {
+        Node* node = takeNode();
+        T* object = new (node->storage) T(std::forward<Args>(args)...);
+        node->live = true;
+        ++liveCount;
+        return object;
+    }
+
+    void destroy(T* object)
+    {
+        if (!object) return;
+
+        // storage - первое поле Node, адреса совпадают
+        Node* node = reinterpret_cast<Node*>(object);
+        object->~T();
+        node->live = false;
+        node->next = freeList;
+        freeList = node;
+        --liveCount;
+    }
+
+    // Уничтожает все живые объекты и освобождает блоки целиком
+    void clear()
+    {
+        if (!std::is_trivially_destructible<T>::value && liveCount) {
+            for (size_t b = 0; b < blocks.size(); ++b) {
+                size_t used = (b + 1 == blocks.size()) ? usedInLastBlock : BlockSize;
+                for (size_t i = 0; i < used; ++i) {
+                    Node& node = blocks[b][i];
+                    if (node.live) {
+                        reinterpret_cast<T*>(node.storage)->~T();
+                    }
+                }
+            }
+        }
+
+        blocks.clear();
+        freeList = nullptr;
+        usedInLastBlock = BlockSize;
+        liveCount = 0;
+    }
+
+    size_t size() const { return liveCount; }
+
+private:
+    struct Node {
+        alignas(T) unsigned char storage[sizeof(T)];
+        Node* next;
+        bool live;
+    };
+
+    std::vector<std::unique_ptr<Node[]>> blocks;
+    Node* freeList = nullptr;
+    size_t usedInLastBlock = BlockSize;
+    size_t liveCount = 0;
+
+    Node* takeNode()
+    {
+        if (freeList) {
+            Node* node = freeList;
+            freeList = node->next;
+            return node;
+        }
+
+        if (usedInLastBlock == BlockSize) {
+            blocks.push_back(std::unique_ptr<Node[]>(new Node[BlockSize]));
+            usedInLastBlock = 0;
+        }
+        return &blocks.back()[usedInLastBlock++];
+    }
+};
+
+#endif // OBJECTPOOL_H
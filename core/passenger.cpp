@@ -1,4 +1,5 @@
 #include "passenger.h"
+#include "station.h"
 #include <sstream>
 
 Passenger::Passenger(int passport, const std::string& fname, const std::string& lname)
@@ -9,28 +10,45 @@ int Passenger::getPassport() const {
     return passportNumber;
 }
 
-std::string Passenger::getFirstName() const {
+const std::string& Passenger::getFirstName() const {
     return firstName;
 }
 
-std::string Passenger::getLastName() const {
+const std::string& Passenger::getLastName() const {
     return lastName;
 }
 
 void Passenger::setPassport(int newPassport){
+    if (owner) owner->unindexPassenger(this);
     passportNumber = newPassport;
+    if (owner) owner->indexPassenger(this);
+    if (owner) owner->onPassengerChanged(this);
 }
 
 void Passenger::setFName(const std::string& newFName){
+    if (owner) owner->unindexPassengerName(this);
     firstName = newFName;
+    if (owner) owner->indexPassengerName(this);
+    if (owner) owner->onPassengerChanged(this);
 }
 
 void Passenger::setLName(const std::string& newLName){
+    if (owner) owner->unindexPassengerName(this);
     lastName = newLName;
+    if (owner) owner->indexPassengerName(this);
+    if (owner) owner->onPassengerChanged(this);
 }
 
 std::string Passenger::getFullName() const {
-    return lastName + " " + firstName;
+    std::string fullName;
+    formatFullName(fullName);
+    return fullName;
+}
+
+void Passenger::formatFullName(std::string& buffer) const {
+    buffer.clear();
+    buffer.reserve(lastName.size() + 1 + firstName.size());
+    buffer.append(lastName).append(1, ' ').append(firstName);
 }
 
 std::string Passenger::getInfo() const {
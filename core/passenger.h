@@ -2,6 +2,9 @@
 #define PASSENGER_H
 
 #include <string>
+#include <cstdint>
+
+class Station;
 
 class Passenger {
 private:
@@ -9,18 +12,29 @@ private:
     std::string firstName;
     std::string lastName;
 
+    // Станция, в индексах которой зарегистрирован пассажир
+    Station* owner = nullptr;
+    // Числовой ключ пассажира в колоночной книге продаж станции
+    std::uint32_t key = 0;
+    // Позиция пассажира в списке станции
+    std::uint32_t row = 0;
+
+    friend class Station;
+
 public:
     Passenger(int passport, const std::string& fname, const std::string& lname);
 
     int getPassport() const;
-    std::string getFirstName() const;
-    std::string getLastName() const;
+    const std::string& getFirstName() const;
+    const std::string& getLastName() const;
 
     void setPassport(int newPassport);
     void setFName(const std::string& newFName);
     void setLName(const std::string& newLName);
 
     std::string getFullName() const;
+    // Записывает "Фамилия Имя" в buffer, переиспользуя его память
+    void formatFullName(std::string& buffer) const;
     std::string getInfo() const;
 };
 
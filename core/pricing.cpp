@@ -0,0 +1,27 @@
+#include "pricing.h"
+#include "tariff.h"
+
+std::int32_t vagonMultiplier(VagonType type)
+{
+    switch (type) {
+    case PLAC: return 3;
+    case KUPE: return 4;
+    case SIT:  return 2;
+    }
+    return 2;
+}
+
+PriceFactors resolvePriceFactors(const Tariff& tariff)
+{
+    return PriceFactors{tariff.getBasePrice().getKopecks(),
+                        vagonMultiplier(tariff.getVType()),
+                        tariff.getDiscount()->getPriceShare()};
+}
+
+void computePrice(const PriceFactors& factors, Money& price, Money& fullPrice)
+{
+    // Половина копейки округляется вверх
+    std::int64_t full = (factors.basePrice * factors.multiplier + 1) / 2;
+    fullPrice = Money(full);
+    price = Money(applyPriceShare(full, factors.priceShare));
+}
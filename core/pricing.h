@@ -0,0 +1,39 @@
+#ifndef PRICING_H
+#define PRICING_H
+
+#include "types.h"
+#include "money.h"
+#include <cstdint>
+
+class Tariff;
+
+// Расчет цены тарифа.
+// Тариф сводится к тройке целых множителей (виртуальный вызов скидки происходит
+// только здесь), после чего цена считается в целых копейках; так Tariff обновляет
+// кэш цены при каждом изменении.
+// NoDiscount/CustomDiscount остаются слоем конфигурации скидок.
+struct PriceFactors {
+    std::int64_t basePrice;   // базовая цена в копейках
+    std::int32_t multiplier;  // множитель типа вагона в половинах (2 = x1)
+    std::int32_t priceShare;  // доля цены после скидки в сотых долях процента
+};
+
+// Доля цены без скидки
+constexpr std::int32_t FULL_PRICE_SHARE = 10000;
+
+// Применение доли цены с округлением до копейки
+inline std::int64_t applyPriceShare(std::int64_t kopecks, std::int32_t share)
+{
+    return (kopecks * share + FULL_PRICE_SHARE / 2) / FULL_PRICE_SHARE;
+}
+
+// Множитель цены для типа вагона, в половинах
+std::int32_t vagonMultiplier(VagonType type);
+
+// Сведение тарифа к множителям
+PriceFactors resolvePriceFactors(const Tariff& tariff);
+
+// Расчет цены: fullPrice - без скидки, price - со скидкой
+void computePrice(const PriceFactors& factors, Money& price, Money& fullPrice);
+
+#endif // PRICING_H
@@ -0,0 +1,56 @@
+#include "radixsort.h"
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <utility>
+
+std::vector<std::uint32_t> radixSortPermutation(const std::vector<std::int64_t>& keys, bool descending)
+{
+    const unsigned DIGIT_BITS = 16;
+    const size_t BUCKETS = size_t(1) << DIGIT_BITS;
+
+    size_t n = keys.size();
+
+    // Знаковые ключи переводятся в беззнаковый порядок; для убывания инвертируются
+    std::vector<std::uint64_t> sortKeys(n);
+    for (size_t i = 0; i < n; ++i) {
+        std::uint64_t key = static_cast<std::uint64_t>(keys[i]) ^ (std::uint64_t(1) << 63);
+        sortKeys[i] = descending ? ~key : key;
+    }
+
+    std::vector<std::uint32_t> index(n);
+    std::iota(index.begin(), index.end(), 0);
+
+    std::vector<std::uint64_t> keyBuffer(n);
+    std::vector<std::uint32_t> indexBuffer(n);
+    std::vector<size_t> counts(BUCKETS);
+
+    for (unsigned shift = 0; shift < 64; shift += DIGIT_BITS) {
+        std::fill(counts.begin(), counts.end(), 0);
+        for (size_t i = 0; i < n; ++i) {
+            ++counts[(sortKeys[i] >> shift) & (BUCKETS - 1)];
+        }
+
+        // Все ключи имеют одинаковый разряд - проход ничего не меняет
+        if (n == 0 || counts[(sortKeys[0] >> shift) & (BUCKETS - 1)] == n) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t& count : counts) {
+            size_t next = offset + count;
+            count = offset;
+            offset = next;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            size_t target = counts[(sortKeys[i] >> shift) & (BUCKETS - 1)]++;
+            keyBuffer[target] = sortKeys[i];
+            indexBuffer[target] = index[i];
+        }
+        std::swap(sortKeys, keyBuffer);
+        std::swap(index, indexBuffer);
+    }
+
+    return index;
+}
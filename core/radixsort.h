@@ -0,0 +1,14 @@
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <cstdint>
+#include <vector>
+
+// Устойчивая сортировка индексов по 64-битным ключам (LSD radix sort, разряды по 16 бит).
+// Возвращает перестановку: result[i] - индекс i-го по порядку ключа.
+// Равные ключи сохраняют исходный порядок индексов и при сортировке по убыванию.
+// Проходы по разрядам, одинаковым у всех ключей, пропускаются, поэтому паспорта
+// и цены обычно сортируются за два-три прохода
+std::vector<std::uint32_t> radixSortPermutation(const std::vector<std::int64_t>& keys, bool descending);
+
+#endif // RADIXSORT_H
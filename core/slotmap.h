@@ -0,0 +1,155 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+// Хранилище со стабильными ключами (slot map).
+// Значения лежат плотно в массиве values, ключ указывает на слот, а слот - на позицию
+// значения. Вставка, удаление и поиск по ключу выполняются за O(1), удаление переносит
+// последнее значение на место удаленного. Каждый ключ содержит поколение слота, поэтому
+// ключ удаленного элемента не совпадет с ключом элемента, занявшего тот же слот.
+template <typename T>
+class SlotMap {
+public:
+    // Ключ: старшие 32 бита - поколение, младшие - номер слота. 0 - недействительный ключ
+    typedef std::uint64_t Key;
+    static constexpr Key INVALID_KEY = 0;
+
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    Key insert(T value)
+    {
+        std::uint32_t slotIndex;
+        if (!freeSlots.empty()) {
+            slotIndex = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slotIndex = static_cast<std::uint32_t>(slots.size());
+            slots.push_back(Slot{0, 1});
+        }
+
+        slots[slotIndex].denseIndex = static_cast<std::uint32_t>(values.size());
+        values.push_back(std::move(value));
+        denseToSlot.push_back(slotIndex);
+
+        return makeKey(slotIndex, slots[slotIndex].generation);
+    }
+
+    bool erase(Key key)
+    {
+        size_t pos = indexOf(key);
+        if (pos == npos) {
+            return false;
+        }
+
+        std::uint32_t slotIndex = slotOf(key);
+        size_t last = values.size() - 1;
+
+        if (pos != last) {
+            values[pos] = std::move(values[last]);
+            denseToSlot[pos] = denseToSlot[last];
+            slots[denseToSlot[pos]].denseIndex = static_cast<std::uint32_t>(pos);
+        }
+        values.pop_back();
+        denseToSlot.pop_back();
+
+        retireSlot(slotIndex);
+        return true;
+    }
+
+    // Позиция значения в плотном массиве или npos
+    size_t indexOf(Key key) const
+    {
+        std::uint32_t slotIndex = slotOf(key);
+        if (key == INVALID_KEY || slotIndex >= slots.size()) {
+            return npos;
+        }
+
+        const Slot& slot = slots[slotIndex];
+        if (slot.generation != generationOf(key) || slot.denseIndex == FREE) {
+            return npos;
+        }
+        return slot.denseIndex;
+    }
+
+    T* find(Key key)
+    {
+        size_t pos = indexOf(key);
+        return pos == npos ? nullptr : &values[pos];
+    }
+
+    const T* find(Key key) const
+    {
+        size_t pos = indexOf(key);
+        return pos == npos ? nullptr : &values[pos];
+    }
+
+    // Ключ значения, стоящего на позиции pos плотного массива
+    Key keyAt(size_t pos) const
+    {
+        std::uint32_t slotIndex = denseToSlot[pos];
+        return makeKey(slotIndex, slots[slotIndex].generation);
+    }
+
+    const T* data() const { return values.data(); }
+
+    T& operator[](size_t pos) { return values[pos]; }
+    const T& operator[](size_t pos) const { return values[pos]; }
+
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+
+    iterator begin() { return values.begin(); }
+    iterator end() { return values.end(); }
+    const_iterator begin() const { return values.begin(); }
+    const_iterator end() const { return values.end(); }
+
+    // Удаляет все значения; выданные ранее ключи остаются недействительными
+    void clear()
+    {
+        for (std::uint32_t slotIndex : denseToSlot) {
+            retireSlot(slotIndex);
+        }
+        values.clear();
+        denseToSlot.clear();
+    }
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    struct Slot {
+        std::uint32_t denseIndex;
+        std::uint32_t generation;
+    };
+
+    static constexpr std::uint32_t FREE = static_cast<std::uint32_t>(-1);
+
+    std::vector<Slot> slots;
+    std::vector<T> values;
+    std::vector<std::uint32_t> denseToSlot;
+    std::vector<std::uint32_t> freeSlots;
+
+    void retireSlot(std::uint32_t slotIndex)
+    {
+        Slot& slot = slots[slotIndex];
+        slot.denseIndex = FREE;
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        freeSlots.push_back(slotIndex);
+    }
+
+    static Key makeKey(std::uint32_t slotIndex, std::uint32_t generation)
+    {
+        return (static_cast<Key>(generation) << 32) | slotIndex;
+    }
+
+    static std::uint32_t slotOf(Key key) { return static_cast<std::uint32_t>(key); }
+    static std::uint32_t generationOf(Key key) { return static_cast<std::uint32_t>(key >> 32); }
+};
+
+#endif // SLOTMAP_H
@@ -1,6 +1,7 @@
 #include "station.h"
 #include <algorithm>
 #include <numeric>
+#include <unordered_set>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -8,95 +9,348 @@
 void Station::connectDiscountManager(DiscountManager* dM)
 {
     discountManager = dM;
+    discountManager->setReplaceHandler(
+        [this](const DiscountStrategy* oldDiscount, const DiscountHandle& newDiscount) {
+            onDiscountReplaced(oldDiscount, newDiscount);
+        });
+}
+
+void Station::addChangeHandler(ChangeHandler handler)
+{
+    changeHandlers.push_back(std::move(handler));
+}
+
+// Рассылка уведомления подписчикам
+void Station::notify(EntityKind entity, ChangeType type, size_t row, std::uint64_t id)
+{
+    if (notificationsSuspended) return;
+
+    ChangeEvent event{entity, type, row, id};
+    for (const auto& handler : changeHandlers) {
+        handler(event);
+    }
+}
+
+// Все списки станции заменены целиком
+void Station::notifyReset()
+{
+    notify(ENTITY_PASSENGER, CHANGE_RESET, 0, 0);
+    notify(ENTITY_TARIFF, CHANGE_RESET, 0, 0);
+    notify(ENTITY_TICKET, CHANGE_RESET, 0, 0);
+}
+
+void Station::resumeNotifications()
+{
+    notificationsSuspended = false;
+    notifyReset();
+}
+
+// Перевод тарифов на новую версию скидки (за один проход, без выделений памяти)
+void Station::onDiscountReplaced(const DiscountStrategy* oldDiscount, const DiscountHandle& newDiscount)
+{
+    for (Tariff* tariff : tariffs) {
+        if (tariff->getDiscount() == oldDiscount) {
+            tariff->setDiscount(newDiscount);
+        }
+    }
+}
+
+Passenger* Station::addPassenger(int passport, const std::string& fname, const std::string& lname)
+{
+    return registerPassenger(passengerPool.create(passport, fname, lname));
+}
+
+Tariff* Station::addTariff(const std::string& name, Money price, VagonType type,
+                           DiscountHandle discount)
+{
+    return registerTariff(tariffPool.create(name, price, type, std::move(discount)));
 }
 
 void Station::addPassenger(std::unique_ptr<Passenger> passenger)
 {
-    passengers.push_back(std::move(passenger));
+    registerPassenger(passengerPool.create(std::move(*passenger)));
 }
 
 void Station::addTariff(std::unique_ptr<Tariff> tariff)
 {
-    tariffs.push_back(std::move(tariff));
+    registerTariff(tariffPool.create(std::move(*tariff)));
 }
 
-void Station::buyTicket(Passenger* passenger, Tariff* tariff)
+Passenger* Station::registerPassenger(Passenger* passenger)
 {
-    tickets.push_back(std::make_unique<Ticket>(passenger, tariff));
+    passenger->owner = this;
+    passenger->key = static_cast<std::uint32_t>(passengersByKey.size());
+    passengersByKey.push_back(passenger);
+    indexPassenger(passenger);
+    indexPassengerName(passenger);
+    passenger->row = static_cast<std::uint32_t>(passengers.size());
+    passengers.push_back(passenger);
+    notify(ENTITY_PASSENGER, CHANGE_INSERTED, passengers.size() - 1, passenger->key);
+    return passenger;
 }
 
-// Удаление пассажира по паспорту
-bool Station::removePassenger(int passport)
+Tariff* Station::registerTariff(Tariff* tariff)
 {
-    // Проверка на наличие билетов
-    for (const auto& ticket : tickets) {
-        if (ticket->getPassportNumber() == passport) {
-            return false;
-        }
+    tariff->owner = this;
+    tariff->key = static_cast<std::uint32_t>(tariffsByKey.size());
+    tariffsByKey.push_back(tariff);
+    indexTariff(tariff);
+    tariff->row = static_cast<std::uint32_t>(tariffs.size());
+    tariffs.push_back(tariff);
+    notify(ENTITY_TARIFF, CHANGE_INSERTED, tariffs.size() - 1, tariff->key);
+    return tariff;
+}
+
+TicketId Station::buyTicket(Passenger* passenger, Tariff* tariff)
+{
+    Ticket* ticket = ticketPool.create(passenger, tariff);
+    ticket->owner = this;
+    linkTicket(ticket);
+
+    ticket->id = tickets.insert(ticket);
+
+    Money price = tariff->calculatePrice(false);
+    Money fullPrice = tariff->calculatePrice(true);
+    ledger.append(passenger->key, tariff->key, price, fullPrice);
+    addRevenue(price, fullPrice);
+    notify(ENTITY_TICKET, CHANGE_INSERTED, tickets.size() - 1, ticket->id);
+    return ticket->id;
+}
+
+// Регистрация пассажира в индексе паспортов. Паспорта уникальны: окно проверяет
+// их при добавлении и изменении, загрузка и журнал пропускают повторы
+void Station::indexPassenger(Passenger* passenger)
+{
+    passengersByPassport.emplace(passenger->getPassport(), passenger);
+}
+
+// Удаление пассажира из индекса паспортов
+void Station::unindexPassenger(Passenger* passenger)
+{
+    auto it = passengersByPassport.find(passenger->getPassport());
+    if (it != passengersByPassport.end() && it->second == passenger) {
+        passengersByPassport.erase(it);
     }
+}
 
-    auto it = std::find_if(passengers.begin(), passengers.end(),
-                           [passport](const std::unique_ptr<Passenger>& p) {
-                               return p->getPassport() == passport;
-                           });
+// Регистрация пассажира в поисковом индексе имен
+void Station::indexPassengerName(Passenger* passenger)
+{
+    passengersByName.insert(passenger->key, passenger->getLastName(), passenger->getFirstName());
+}
 
-    if (it != passengers.end()) {
-        passengers.erase(it);
-        return true;
+// Удаление пассажира из поискового индекса имен
+void Station::unindexPassengerName(Passenger* passenger)
+{
+    passengersByName.erase(passenger->key);
+}
+
+// Регистрация тарифа в индексе названий
+void Station::indexTariff(Tariff* tariff)
+{
+    tariffsByName.emplace(tariff->name, tariff);
+    tariffsByNameText.insert(tariff->key, tariff->name);
+    indexTariffPrice(tariff, tariff->calculatePrice(false));
+}
+
+// Удаление тарифа из индекса названий
+void Station::unindexTariff(Tariff* tariff)
+{
+    auto it = tariffsByName.find(tariff->name);
+    if (it != tariffsByName.end() && it->second == tariff) {
+        tariffsByName.erase(it);
     }
+    tariffsByNameText.erase(tariff->key);
+    unindexTariffPrice(tariff, tariff->calculatePrice(false));
+}
 
-    return false;
+// Добавление тарифа в индекс цен
+void Station::indexTariffPrice(const Tariff* tariff, Money price)
+{
+    tariffsByPrice.emplace(price.getKopecks(), tariff->key);
 }
 
-// Удаление тарифа по названию
-bool Station::removeTariff(const std::string& name)
+void Station::unindexTariffPrice(const Tariff* tariff, Money price)
 {
-    // Проверка на наличие билетов
-    for (const auto& ticket : tickets) {
-        if (ticket->getDestination() == name) {
-            return false;
+    tariffsByPrice.erase({price.getKopecks(), tariff->key});
+}
+
+// Добавление билета в списки его пассажира и тарифа
+void Station::linkTicket(Ticket* ticket)
+{
+    auto link = [ticket](auto& list, std::uint32_t Ticket::*slot) {
+        ticket->*slot = static_cast<std::uint32_t>(list.size());
+        list.push_back(ticket);
+    };
+
+    link(ticketsByPassenger[ticket->getPassenger()], &Ticket::passengerSlot);
+    link(ticketsByTariff[ticket->getTariff()], &Ticket::tariffSlot);
+
+    // Билет уже в книге продаж - обновляем его строку
+    size_t row = tickets.indexOf(ticket->id);
+    if (row != tickets.npos) {
+        Tariff* tariff = ticket->getTariff();
+        Money price = tariff->calculatePrice(false);
+        Money fullPrice = tariff->calculatePrice(true);
+
+        addRevenue(price - Money(ledger.getPrices(false)[row]), fullPrice - Money(ledger.getPrices(true)[row]));
+        ledger.setRow(row, ticket->getPassenger()->key, tariff->key, price, fullPrice);
+        notify(ENTITY_TICKET, CHANGE_UPDATED, row, ticket->id);
+    }
+}
+
+// Учет изменения выручки
+void Station::addRevenue(Money price, Money fullPrice)
+{
+    revenue += price;
+    fullRevenue += fullPrice;
+}
+
+// Удаление билета из списков его пассажира и тарифа за O(1): на его место
+// переносится последний билет списка
+void Station::unlinkTicket(Ticket* ticket)
+{
+    auto unlink = [ticket](auto& adjacency, auto key, std::uint32_t Ticket::*slot) {
+        auto it = adjacency.find(key);
+        if (it == adjacency.end()) return;
+        auto& list = it->second;
+        Ticket* last = list.back();
+        list[ticket->*slot] = last;
+        last->*slot = ticket->*slot;
+        list.pop_back();
+        if (list.empty()) adjacency.erase(it);
+    };
+
+    unlink(ticketsByPassenger, static_cast<const Passenger*>(ticket->getPassenger()), &Ticket::passengerSlot);
+    unlink(ticketsByTariff, static_cast<const Tariff*>(ticket->getTariff()), &Ticket::tariffSlot);
+}
+
+// Пересчет цен в книге продаж для билетов тарифа
+void Station::onTariffPriceChanged(Tariff* tariff, Money oldPrice)
+{
+    unindexTariffPrice(tariff, oldPrice);
+    indexTariffPrice(tariff, tariff->calculatePrice(false));
+
+    auto it = ticketsByTariff.find(tariff);
+    if (it != ticketsByTariff.end()) {
+        const std::vector<Ticket*>& tariffTickets = it->second;
+        Money price = tariff->calculatePrice(false);
+        Money fullPrice = tariff->calculatePrice(true);
+
+        // Все билеты тарифа стоят одинаково: изменение выручки = разница цен * число билетов
+        size_t firstRow = tickets.indexOf(tariffTickets.front()->id);
+        std::int64_t count = static_cast<std::int64_t>(tariffTickets.size());
+        addRevenue((price - Money(ledger.getPrices(false)[firstRow])) * count,
+                   (fullPrice - Money(ledger.getPrices(true)[firstRow])) * count);
+
+        for (Ticket* ticket : tariffTickets) {
+            ledger.setPrice(tickets.indexOf(ticket->id), price, fullPrice);
         }
     }
 
-    auto it = std::find_if(tariffs.begin(), tariffs.end(),
-                           [&name](const std::unique_ptr<Tariff>& t) {
-                               return t->getName() == name;
-                           });
+    onTariffChanged(tariff);
+}
+
+// Уведомление об изменении пассажира (имя, паспорт)
+void Station::onPassengerChanged(Passenger* passenger)
+{
+    notify(ENTITY_PASSENGER, CHANGE_UPDATED, passenger->row, passenger->key);
+}
+
+// Уведомление об изменении тарифа (название, цена, скидка)
+void Station::onTariffChanged(Tariff* tariff)
+{
+    notify(ENTITY_TARIFF, CHANGE_UPDATED, tariff->row, tariff->key);
+}
+
+// Удаление пассажира по паспорту
+bool Station::removePassenger(int passport)
+{
+    Passenger* passenger = findPassengerByPassport(passport);
+    if (!passenger) {
+        return false;
+    }
 
-    if (it != tariffs.end()) {
-        tariffs.erase(it);
-        return true;
+    // Проверка на наличие билетов
+    if (ticketsByPassenger.count(passenger)) {
+        return false;
     }
 
-    return false;
+    unindexPassenger(passenger);
+    unindexPassengerName(passenger);
+    passengersByKey[passenger->key] = nullptr;
+    // Следующие пассажиры сдвигаются на одну позицию
+    size_t row = passenger->row;
+    passengers.erase(passengers.begin() + row);
+    for (size_t i = row; i < passengers.size(); ++i) {
+        passengers[i]->row = static_cast<std::uint32_t>(i);
+    }
+    std::uint32_t key = passenger->key;
+    passengerPool.destroy(passenger);
+    notify(ENTITY_PASSENGER, CHANGE_REMOVED, row, key);
+    return true;
 }
 
-// Удаление билета по индексу
-bool Station::removeTicket(int ticketIndex)
+// Удаление тарифа по названию
+bool Station::removeTariff(std::string_view name)
 {
-    if (ticketIndex >= 0 && static_cast<size_t>(ticketIndex) < tickets.size()) {
-        tickets.erase(tickets.begin() + ticketIndex);
-        return true;
+    Tariff* tariff = getTariffByName(name);
+    if (!tariff) {
+        return false;
     }
-    return false;
+
+    // Проверка на наличие билетов
+    if (ticketsByTariff.count(tariff)) {
+        return false;
+    }
+
+    unindexTariff(tariff);
+    tariffsByKey[tariff->key] = nullptr;
+    // Следующие тарифы сдвигаются на одну позицию
+    size_t row = tariff->row;
+    tariffs.erase(tariffs.begin() + row);
+    for (size_t i = row; i < tariffs.size(); ++i) {
+        tariffs[i]->row = static_cast<std::uint32_t>(i);
+    }
+    std::uint32_t key = tariff->key;
+    tariffPool.destroy(tariff);
+    notify(ENTITY_TARIFF, CHANGE_REMOVED, row, key);
+    return true;
+}
+
+// Удаление билета по идентификатору
+bool Station::removeTicket(TicketId id)
+{
+    Ticket* ticket = getTicket(id);
+    if (!ticket) {
+        return false;
+    }
+
+    unlinkTicket(ticket);
+
+    size_t row = tickets.indexOf(id);
+    Money price(ledger.getPrices(false)[row]);
+    Money fullPrice(ledger.getPrices(true)[row]);
+    ledger.removeAt(row);
+    tickets.erase(id);
+    addRevenue(-price, -fullPrice);
+    ticketPool.destroy(ticket);
+    notify(ENTITY_TICKET, CHANGE_REMOVED, row, id);
+    return true;
 }
 
 // Поиск пассажира по паспорту
 Passenger* Station::findPassengerByPassport(int passport) const
 {
-    auto it = std::find_if(passengers.begin(), passengers.end(),
-                           [passport](const std::unique_ptr<Passenger>& p) {
-                               return p->getPassport() == passport;
-                           });
-
-    return (it != passengers.end()) ? it->get() : nullptr;
+    auto it = passengersByPassport.find(passport);
+    return (it != passengersByPassport.end()) ? it->second : nullptr;
 }
 
 // Получение пассажира по индексу
 Passenger* Station::getPassengerAt(int index) const
 {
     if (index >= 0 && static_cast<size_t>(index) < passengers.size()) {
-        return passengers[index].get();
+        return passengers[index];
     }
     return nullptr;
 }
@@ -105,59 +359,67 @@ Passenger* Station::getPassengerAt(int index) const
 Tariff* Station::getTariffAt(int index) const
 {
     if (index >= 0 && static_cast<size_t>(index) < tariffs.size()) {
-        return tariffs[index].get();
+        return tariffs[index];
     }
     return nullptr;
 }
 
 // Получение тарифа по названию
-Tariff* Station::getTariffByName(const std::string& name) const
+Tariff* Station::getTariffByName(std::string_view name) const
 {
-    auto it = std::find_if(tariffs.begin(), tariffs.end(),
-                           [&name](const std::unique_ptr<Tariff>& t) {
-                               return t->getName() == name;
-                           });
+    auto it = tariffsByName.find(name);
+    return (it != tariffsByName.end()) ? it->second : nullptr;
+}
 
-    return (it != tariffs.end()) ? it->get() : nullptr;
+// Позиции записей в списках станции (-1, если запись не принадлежит станции)
+int Station::getPassengerRow(const Passenger* passenger) const
+{
+    return passenger && passenger->owner == this ? static_cast<int>(passenger->row) : -1;
+}
+
+int Station::getTariffRow(const Tariff* tariff) const
+{
+    return tariff && tariff->owner == this ? static_cast<int>(tariff->row) : -1;
+}
+
+int Station::getTicketRow(TicketId id) const
+{
+    size_t row = tickets.indexOf(id);
+    return row != tickets.npos ? static_cast<int>(row) : -1;
 }
 
 // Получение билета по индексу
 Ticket* Station::getTicketAt(int index) const
 {
     if (index >= 0 && static_cast<size_t>(index) < tickets.size()) {
-        return tickets[index].get();
+        return tickets[index];
     }
     return nullptr;
 }
 
+// Получение билета по идентификатору
+Ticket* Station::getTicket(TicketId id) const
+{
+    auto ticket = tickets.find(id);
+    return ticket ? *ticket : nullptr;
+}
+
 // Получение всех пассажиров
-std::vector<Passenger*> Station::getAllPassengers() const
+EntityView<Passenger> Station::getAllPassengers() const
 {
-    std::vector<Passenger*> result;
-    for (const auto& p : passengers) {
-        result.push_back(p.get());
-    }
-    return result;
+    return EntityView<Passenger>(passengers.data(), passengers.data() + passengers.size());
 }
 
 // Получение всех тарифов
-std::vector<Tariff*> Station::getAllTariffs() const
+EntityView<Tariff> Station::getAllTariffs() const
 {
-    std::vector<Tariff*> result;
-    for (const auto& t : tariffs) {
-        result.push_back(t.get());
-    }
-    return result;
+    return EntityView<Tariff>(tariffs.data(), tariffs.data() + tariffs.size());
 }
 
 // Получение всех билетов
-std::vector<Ticket*> Station::getAllTickets() const
+EntityView<Ticket> Station::getAllTickets() const
 {
-    std::vector<Ticket*> result;
-    for (const auto& t : tickets) {
-        result.push_back(t.get());
-    }
-    return result;
+    return EntityView<Ticket>(tickets.data(), tickets.data() + tickets.size());
 }
 
 // Получение количества пассажиров
@@ -181,59 +443,117 @@ size_t Station::getTicketCount() const
 // Получение билетов по номеру паспорта
 std::vector<Ticket*> Station::getTicketsByPassport(int passport) const
 {
-    std::vector<Ticket*> result;
-    for (const auto& ticket : tickets) {
-        if (ticket->getPassportNumber() == passport) {
-            result.push_back(ticket.get());
-        }
+    auto it = ticketsByPassenger.find(findPassengerByPassport(passport));
+    if (it == ticketsByPassenger.end()) {
+        return {};
     }
-    return result;
+    return it->second;
 }
 
 // Получение билетов по названию тарифа
-std::vector<Ticket*> Station::getTicketsByTariff(const std::string& tariffName) const
+std::vector<Ticket*> Station::getTicketsByTariff(std::string_view tariffName) const
 {
-    std::vector<Ticket*> result;
-    for (const auto& ticket : tickets) {
-        if (ticket->getDestination() == tariffName) {
-            result.push_back(ticket.get());
-        }
+    auto it = ticketsByTariff.find(getTariffByName(tariffName));
+    if (it == ticketsByTariff.end()) {
+        return {};
     }
-    return result;
+    return it->second;
 }
 
 // Получение самого дешевого тарифа
 Tariff* Station::getCheapestTariff() const
 {
-    if (tariffs.empty()) {
+    if (tariffsByPrice.empty()) {
         return nullptr;
     }
+    return tariffsByKey[tariffsByPrice.begin()->second];
+}
 
-    auto it = std::min_element(tariffs.begin(), tariffs.end(),
-                               [](const std::unique_ptr<Tariff>& a, const std::unique_ptr<Tariff>& b) {
-                                   return a->calculatePrice(false) < b->calculatePrice(false);
-                               });
+// Общая выручка (со скидками/ без скидок), O(1) за счет накопленных сумм
+Money Station::getTotalRevenue(bool withoutDiscounts) const
+{
+    return withoutDiscounts ? fullRevenue : revenue;
+}
 
-    return it->get();
+// Разбивка выручки: один проход по книге продаж с итогами по тарифам,
+// затем сведение тарифов в группы
+std::vector<RevenueGroup> Station::getRevenueBreakdown(RevenueGrouping grouping) const
+{
+    return groupTariffTotals(*this, ledger.totalsByTariff(tariffsByKey.size()), grouping);
 }
 
-// Расчет общей выручки (со скидками/ без скидок)
-float Station::getTotalRevenue(bool withoutDiscounts) const
+// Поиск пассажиров по началу "Фамилия Имя", в алфавитном порядке
+std::vector<Passenger*> Station::findPassengersByNamePrefix(std::string_view prefix, size_t limit) const
 {
-    float sum = 0;
-    for (const auto& t : tickets) {
-        sum+=t->getPrice(withoutDiscounts);
+    std::vector<Passenger*> result;
+    for (std::uint32_t key : passengersByName.findPrefix(prefix, limit)) {
+        result.push_back(passengersByKey[key]);
     }
-    return sum;
+    return result;
 }
 
-// Сохранение в файл
-bool Station::saveToFile(const std::string& filename, bool isAuto, bool automode) const
+// Поиск пассажиров по подстроке "Фамилия Имя", в порядке добавления
+std::vector<Passenger*> Station::findPassengersByNameSubstring(std::string_view text, size_t limit) const
 {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        return false;
+    std::vector<Passenger*> result;
+    for (std::uint32_t key : passengersByName.findSubstring(text, limit)) {
+        result.push_back(passengersByKey[key]);
+    }
+    return result;
+}
+
+std::vector<Tariff*> Station::findTariffsByName(std::string_view text, size_t limit) const
+{
+    std::vector<std::uint32_t> keys = tariffsByNameText.findPrefix(text, limit);
+    std::unordered_set<std::uint32_t> found(keys.begin(), keys.end());
+    for (std::uint32_t key : tariffsByNameText.findSubstring(text, limit)) {
+        if (keys.size() >= limit) break;
+        if (!found.count(key)) {
+            keys.push_back(key);
+        }
+    }
+
+    std::vector<Tariff*> result;
+    for (std::uint32_t key : keys) {
+        result.push_back(tariffsByKey[key]);
     }
+    return result;
+}
+
+// Колоночная книга продаж
+const TicketLedger& Station::getLedger() const
+{
+    return ledger;
+}
+
+// Получение пассажира по ключу книги продаж
+Passenger* Station::getPassengerByKey(std::uint32_t key) const
+{
+    return key < passengersByKey.size() ? passengersByKey[key] : nullptr;
+}
+
+// Получение тарифа по ключу книги продаж
+Tariff* Station::getTariffByKey(std::uint32_t key) const
+{
+    return key < tariffsByKey.size() ? tariffsByKey[key] : nullptr;
+}
+
+// Количество выданных ключей пассажиров
+size_t Station::getPassengerKeyCount() const
+{
+    return passengersByKey.size();
+}
+
+// Количество выданных ключей тарифов (размер таблиц для агрегатов по тарифам)
+size_t Station::getTariffKeyCount() const
+{
+    return tariffsByKey.size();
+}
+
+// Снимок данных в формате файла сохранения
+std::string Station::serialize(bool isAuto, bool automode, std::uint64_t journalSeq) const
+{
+    std::ostringstream file;
 
     // Указываем, статус автосохранения
     if (automode){
@@ -241,6 +561,7 @@ bool Station::saveToFile(const std::string& filename, bool isAuto, bool automode
         if (isAuto) file << "AUTO";
         else file << "NOTAUTO";
         file << "\n";
+        if (journalSeq) file << "SEQ|" << journalSeq << "\n";
     }
 
     // Сохраняем пассажиров
@@ -264,7 +585,7 @@ bool Station::saveToFile(const std::string& filename, bool isAuto, bool automode
     file << "\n[TARIFFS]\n";
     for (const auto& t : tariffs) {
         file << t->getName() << "|"
-             << t->getBasePrice() << "|"
+             << t->getBasePrice().toString() << "|"
              << static_cast<int>(t->getVType()) << "|"
              << t->getDiscount()->getDiscountInfo().name << "\n";
     }
@@ -276,18 +597,36 @@ bool Station::saveToFile(const std::string& filename, bool isAuto, bool automode
              << ticket->getDestination() << "\n";
     }
 
+    return file.str();
+}
+
+// Сохранение в файл
+bool Station::saveToFile(const std::string& filename, bool isAuto, bool automode) const
+{
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << serialize(isAuto, automode);
     file.close();
     return true;
 }
 
 // Загрузка из файла
-bool Station::loadFromFile(const std::string& filename, bool* isAuto, bool automode, bool isCheck)
+bool Station::loadFromFile(const std::string& filename, bool* isAuto, bool automode, bool isCheck,
+                           std::uint64_t* journalSeq)
 {
+    if (journalSeq) *journalSeq = 0;
+
     std::ifstream file(filename);
     if (!file.is_open()) {
         return false;
     }
 
+    // Загружаемые записи не рассылаются по одной
+    notificationsSuspended = true;
+
     // Очищаем текущие данные
     clearAllData();
 
@@ -323,17 +662,23 @@ bool Station::loadFromFile(const std::string& filename, bool* isAuto, bool autom
             if (section == "META" && tokens.size() >= 1) {
                 try {
                     std::string data = tokens[0];
+                    if (data == "SEQ" && tokens.size() >= 2) {
+                        if (journalSeq) *journalSeq = std::stoull(tokens[1]);
+                        continue;
+                    }
                     if (data == "AUTO") dataAuto = true;
                     else if (data == "NOTAUTO") dataAuto = false;
                     if (isCheck){
                         file.close();
                         *isAuto = dataAuto;
+                        resumeNotifications();
                         return true;
                     }
                 } catch (...) {
                     if (isCheck){
                         file.close();
                         *isAuto = false;
+                        resumeNotifications();
                         return false;
                     }
                 }
@@ -343,7 +688,9 @@ bool Station::loadFromFile(const std::string& filename, bool* isAuto, bool autom
                     std::string firstName = tokens[1];
                     std::string lastName = tokens[2];
 
-                    addPassenger(std::make_unique<Passenger>(passport, firstName, lastName));
+                    // Паспорт - ключ пассажира, повторы пропускаются
+                    if (findPassengerByPassport(passport)) continue;
+                    addPassenger(passport, firstName, lastName);
                 } catch (...) {
                     // Пропускаем некорректные записи
                 }
@@ -361,15 +708,24 @@ bool Station::loadFromFile(const std::string& filename, bool* isAuto, bool autom
             } else if (section == "TARIFFS" && tokens.size() >= 4) {
                 try {
                     std::string name = tokens[0];
-                    float price = std::stof(tokens[1]);
-                    VagonType type = static_cast<VagonType>(std::stoi(tokens[2]));
+                    // Название - ключ тарифа, повторы пропускаются
+                    if (getTariffByName(name)) continue;
+                    Money price;
+                    // Цены пишутся в рублях с копейками; старые файлы могли
+                    // содержать экспоненциальную запись float
+                    if (!Money::parse(tokens[1], price)) {
+                        price = Money::fromRubles(std::stod(tokens[1]));
+                    }
+                    int typeNumber = std::stoi(tokens[2]);
+                    if (!isValidVagonType(typeNumber)) continue;
+                    VagonType type = static_cast<VagonType>(typeNumber);
                     std::string discountName = tokens[3];
 
                     auto discount = discountManager->getDiscountByName(discountName);
 
                     if (!discount) discount = discountManager->getDiscountByName("Без скидки");
 
-                    addTariff(std::make_unique<Tariff>(name, price, type, std::move(discount)));
+                    addTariff(name, price, type, std::move(discount));
                 } catch (...) {}
             } else if (section == "TICKETS" && tokens.size() >= 2) {
                 try {
@@ -388,6 +744,7 @@ bool Station::loadFromFile(const std::string& filename, bool* isAuto, bool autom
     }
 
     file.close();
+    resumeNotifications();
     return true;
 }
 
@@ -401,7 +758,26 @@ bool Station::isEmpty(){
 // Очистка всех данных
 void Station::clearAllData()
 {
+    passengersByPassport.clear();
+    passengersByName.clear();
+    tariffsByName.clear();
+    tariffsByNameText.clear();
+    tariffsByPrice.clear();
+    ticketsByPassenger.clear();
+    ticketsByTariff.clear();
+    ledger.clear();
+    revenue = Money();
+    fullRevenue = Money();
+    passengersByKey.clear();
+    tariffsByKey.clear();
     passengers.clear();
     tariffs.clear();
     tickets.clear();
+
+    // Пулы освобождают свои блоки целиком
+    ticketPool.clear();
+    tariffPool.clear();
+    passengerPool.clear();
+
+    notifyReset();
 }
@@ -5,42 +5,135 @@
 #include "tariff.h"
 #include "ticket.h"
 #include "discount.h"
+#include "slotmap.h"
+#include "objectpool.h"
+#include "ledger.h"
+#include "statistics.h"
+#include "nameindex.h"
+#include "entityview.h"
 #include <vector>
 #include <memory>
+#include <unordered_map>
+#include <set>
+#include <string_view>
 
 class Station {
 private:
-    std::vector<std::unique_ptr<Passenger>> passengers;
-    std::vector<std::unique_ptr<Tariff>> tariffs;
-    std::vector<std::unique_ptr<Ticket>> tickets;
+    // Объекты размещаются в пулах; контейнеры хранят указатели на них
+    ObjectPool<Passenger> passengerPool;
+    ObjectPool<Tariff> tariffPool;
+    ObjectPool<Ticket> ticketPool;
+
+    std::vector<Passenger*> passengers;
+    std::vector<Tariff*> tariffs;
+    SlotMap<Ticket*> tickets;
     DiscountManager* discountManager;
 
+    // Индекс паспорт -> пассажир
+    std::unordered_map<int, Passenger*> passengersByPassport;
+
+    // Поисковый индекс "Фамилия Имя" -> ключ пассажира
+    NameIndex passengersByName;
+
+    // Индекс название -> тариф. Ключи ссылаются на строки имен самих тарифов,
+    // поэтому поиск по std::string_view не создает временных строк
+    std::unordered_map<std::string_view, Tariff*> tariffsByName;
+
+    // Поисковый индекс названий тарифов -> ключ тарифа
+    NameIndex tariffsByNameText;
+
+    // Упорядоченный индекс тарифов по итоговой цене: (цена в копейках, ключ тарифа).
+    // Ключ различает тарифы с одинаковой ценой и сохраняет порядок их добавления
+    std::set<std::pair<std::int64_t, std::uint32_t>> tariffsByPrice;
+
+    // Списки билетов каждого пассажира и каждого тарифа
+    std::unordered_map<const Passenger*, std::vector<Ticket*>> ticketsByPassenger;
+    std::unordered_map<const Tariff*, std::vector<Ticket*>> ticketsByTariff;
+
+    // Колоночная книга продаж, строки совпадают с порядком билетов в tickets
+    TicketLedger ledger;
+    std::vector<Passenger*> passengersByKey;
+    std::vector<Tariff*> tariffsByKey;
+
+    // Текущая выручка (со скидками и без), поддерживается при каждом изменении
+    Money revenue;
+    Money fullRevenue;
+
+    void addRevenue(Money price, Money fullPrice);
+
+    // Подписчики на изменения записей. Во время загрузки из файла уведомления
+    // не рассылаются, по окончании подписчики получают сброс всех списков
+    std::vector<ChangeHandler> changeHandlers;
+    bool notificationsSuspended = false;
+
+    void notify(EntityKind entity, ChangeType type, size_t row, std::uint64_t id);
+    void notifyReset();
+    void resumeNotifications();
+
+    // Поддержка индексов (вызывается также из сеттеров Passenger, Tariff и Ticket)
+    void indexPassenger(Passenger* passenger);
+    void unindexPassenger(Passenger* passenger);
+    void indexPassengerName(Passenger* passenger);
+    void unindexPassengerName(Passenger* passenger);
+    void indexTariff(Tariff* tariff);
+    void unindexTariff(Tariff* tariff);
+    void indexTariffPrice(const Tariff* tariff, Money price);
+    void unindexTariffPrice(const Tariff* tariff, Money price);
+    void linkTicket(Ticket* ticket);
+    void unlinkTicket(Ticket* ticket);
+    void onTariffPriceChanged(Tariff* tariff, Money oldPrice);
+    void onPassengerChanged(Passenger* passenger);
+    void onTariffChanged(Tariff* tariff);
+    void onDiscountReplaced(const DiscountStrategy* oldDiscount, const DiscountHandle& newDiscount);
+
+    // Регистрация объекта, уже размещенного в пуле
+    Passenger* registerPassenger(Passenger* passenger);
+    Tariff* registerTariff(Tariff* tariff);
+
+    friend class Passenger;
+    friend class Tariff;
+    friend class Ticket;
+
 public:
     Station() = default;
 
     void connectDiscountManager(DiscountManager* discountManager);
 
-    // Добавление
+    // Подписка на добавление, изменение и удаление пассажиров, тарифов и билетов.
+    // Удаление билета переносит последний билет на место удаленного
+    void addChangeHandler(ChangeHandler handler);
+
+    // Добавление (объект создается в пуле станции)
+    Passenger* addPassenger(int passport, const std::string& fname, const std::string& lname);
+    Tariff* addTariff(const std::string& name, Money price, VagonType type,
+                      DiscountHandle discount = NoDiscount::shared());
+
+    // Добавление готового объекта (содержимое переносится в пул)
     void addPassenger(std::unique_ptr<Passenger> passenger);
     void addTariff(std::unique_ptr<Tariff> tariff);
-    void buyTicket(Passenger* passenger, Tariff* tariff);
+    TicketId buyTicket(Passenger* passenger, Tariff* tariff);
 
     // Удаление
     bool removePassenger(int passport);
-    bool removeTariff(const std::string& name);
-    bool removeTicket(int ticketIndex);
+    bool removeTariff(std::string_view name);
+    bool removeTicket(TicketId id);
 
     // Поиск
     Passenger* findPassengerByPassport(int passport) const;
     Passenger* getPassengerAt(int index) const;
     Tariff* getTariffAt(int index) const;
-    Tariff* getTariffByName(const std::string& name) const;
+    Tariff* getTariffByName(std::string_view name) const;
     Ticket* getTicketAt(int index) const;
+    // Позиция записи в списке станции (-1 - запись не принадлежит станции), O(1)
+    int getPassengerRow(const Passenger* passenger) const;
+    int getTariffRow(const Tariff* tariff) const;
+    int getTicketRow(TicketId id) const;
+    Ticket* getTicket(TicketId id) const;
 
-    // Получение списков
-    std::vector<Passenger*> getAllPassengers() const;
-    std::vector<Tariff*> getAllTariffs() const;
-    std::vector<Ticket*> getAllTickets() const;
+    // Получение списков (без копирования, до следующего добавления/удаления)
+    EntityView<Passenger> getAllPassengers() const;
+    EntityView<Tariff> getAllTariffs() const;
+    EntityView<Ticket> getAllTickets() const;
 
     // Счётчики
     size_t getPassengerCount() const;
@@ -48,15 +141,35 @@ public:
     size_t getTicketCount() const;
     bool isEmpty();
 
+    // Поиск пассажиров по "Фамилия Имя" без учета регистра
+    std::vector<Passenger*> findPassengersByNamePrefix(std::string_view prefix, size_t limit = SIZE_MAX) const;
+    std::vector<Passenger*> findPassengersByNameSubstring(std::string_view text, size_t limit = SIZE_MAX) const;
+
+    // Поиск тарифов по названию без учета регистра: сначала по началу, затем по подстроке
+    std::vector<Tariff*> findTariffsByName(std::string_view text, size_t limit = SIZE_MAX) const;
+
     // Статистика
     std::vector<Ticket*> getTicketsByPassport(int passport) const;
-    std::vector<Ticket*> getTicketsByTariff(const std::string& tariffName) const;
+    std::vector<Ticket*> getTicketsByTariff(std::string_view tariffName) const;
     Tariff* getCheapestTariff() const;
-    float getTotalRevenue(bool withoutDiscounts) const;
+    Money getTotalRevenue(bool withoutDiscounts) const;
+    // Выручка, убыток по скидкам и число билетов по группам за один проход
+    std::vector<RevenueGroup> getRevenueBreakdown(RevenueGrouping grouping) const;
+
+    // Колоночная книга продаж для аналитики
+    const TicketLedger& getLedger() const;
+    Passenger* getPassengerByKey(std::uint32_t key) const;
+    Tariff* getTariffByKey(std::uint32_t key) const;
+    size_t getPassengerKeyCount() const;
+    size_t getTariffKeyCount() const;
 
     // Сохранение/загрузка
+    // serialize() - полное содержимое файла сохранения в памяти (снимок данных);
+    // journalSeq - номер последней записи журнала, вошедшей в снимок (0 - без журнала)
+    std::string serialize(bool isAuto, bool automode, std::uint64_t journalSeq = 0) const;
     bool saveToFile(const std::string& filename, bool isAuto, bool automode) const;
-    bool loadFromFile(const std::string& filename, bool* isAuto, bool automode, bool isCheck);
+    bool loadFromFile(const std::string& filename, bool* isAuto, bool automode, bool isCheck,
+                      std::uint64_t* journalSeq = nullptr);
     void clearAllData();
 };
 
@@ -0,0 +1,163 @@
+#include "statistics.h"
+#include "station.h"
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+// Меньшие диапазоны не окупают запуск потока
+const size_t MIN_ROWS_PER_WORKER = 1 << 15;
+
+// Частичные итоги одного потока
+struct PartialStatistics {
+    std::vector<RevenueTotals> byTariff;
+    // Число билетов пассажира, насыщается на 2 (нужно только "больше одного")
+    std::vector<std::uint8_t> passengerTickets;
+};
+
+// Один проход по строкам [first, last) книги продаж
+void scanRows(const TicketLedger& ledger, size_t first, size_t last, PartialStatistics& partial)
+{
+    const std::uint32_t* passengerKeys = ledger.getPassengerKeys().data();
+    const std::uint32_t* tariffKeys = ledger.getTariffKeys().data();
+    const std::int64_t* prices = ledger.getPrices(false).data();
+    const std::int64_t* fullPrices = ledger.getPrices(true).data();
+
+    RevenueTotals* byTariff = partial.byTariff.data();
+    std::uint8_t* passengerTickets = partial.passengerTickets.data();
+
+    for (size_t i = first; i < last; ++i) {
+        RevenueTotals& totals = byTariff[tariffKeys[i]];
+        totals.revenue += Money(prices[i]);
+        totals.fullRevenue += Money(fullPrices[i]);
+        ++totals.ticketCount;
+
+        std::uint8_t& count = passengerTickets[passengerKeys[i]];
+        if (count < 2) ++count;
+    }
+}
+
+} // namespace
+
+std::vector<RevenueGroup> groupTariffTotals(const Station& station,
+                                            const std::vector<RevenueTotals>& byTariff,
+                                            RevenueGrouping grouping)
+{
+    std::vector<RevenueGroup> groups;
+    std::unordered_map<std::string, size_t> groupIndex;
+
+    if (grouping == GROUP_BY_VAGON) {
+        groups.resize(VAGON_TYPE_COUNT);
+        groups[SIT].name = "Сидячий";
+        groups[PLAC].name = "Плацкарт";
+        groups[KUPE].name = "Купе";
+    }
+
+    for (size_t key = 0; key < byTariff.size(); ++key) {
+        const Tariff* tariff = station.getTariffByKey(static_cast<std::uint32_t>(key));
+        if (!tariff) {
+            continue;
+        }
+
+        switch (grouping) {
+        case GROUP_BY_TARIFF:
+            groups.push_back(RevenueGroup{tariff->getName(), byTariff[key]});
+            break;
+        case GROUP_BY_VAGON:
+            if (isValidVagonType(tariff->getVType())) {
+                groups[tariff->getVType()].totals.merge(byTariff[key]);
+            }
+            break;
+        case GROUP_BY_DISCOUNT: {
+            const std::string& discountName = tariff->getDiscountInfo().name;
+            auto it = groupIndex.find(discountName);
+            if (it == groupIndex.end()) {
+                it = groupIndex.emplace(discountName, groups.size()).first;
+                groups.push_back(RevenueGroup{discountName, RevenueTotals()});
+            }
+            groups[it->second].totals.merge(byTariff[key]);
+            break;
+        }
+        }
+    }
+
+    return groups;
+}
+
+StatisticsEngine::StatisticsEngine(unsigned workerCount)
+    : workerCount(workerCount)
+{
+    if (this->workerCount == 0) {
+        this->workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+unsigned StatisticsEngine::getWorkerCount() const
+{
+    return workerCount;
+}
+
+StationStatistics StatisticsEngine::compute(const Station& station) const
+{
+    const TicketLedger& ledger = station.getLedger();
+    const size_t rows = ledger.size();
+    const size_t tariffKeyCount = station.getTariffKeyCount();
+    const size_t passengerKeyCount = station.getPassengerKeyCount();
+
+    size_t workers = std::min<size_t>(workerCount, std::max<size_t>(1, rows / MIN_ROWS_PER_WORKER));
+
+    std::vector<PartialStatistics> partials(workers);
+    for (PartialStatistics& partial : partials) {
+        partial.byTariff.resize(tariffKeyCount);
+        partial.passengerTickets.resize(passengerKeyCount, 0);
+    }
+
+    // Диапазон строк потока w: [w * rows / workers, (w + 1) * rows / workers)
+    auto rangeBegin = [rows, workers](size_t w) { return w * rows / workers; };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t w = 1; w < workers; ++w) {
+        threads.emplace_back(scanRows, std::cref(ledger), rangeBegin(w), rangeBegin(w + 1),
+                             std::ref(partials[w]));
+    }
+    scanRows(ledger, rangeBegin(0), rangeBegin(1), partials[0]);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Слияние частичных итогов
+    PartialStatistics& merged = partials[0];
+    for (size_t w = 1; w < workers; ++w) {
+        for (size_t key = 0; key < tariffKeyCount; ++key) {
+            merged.byTariff[key].merge(partials[w].byTariff[key]);
+        }
+        for (size_t key = 0; key < passengerKeyCount; ++key) {
+            unsigned count = merged.passengerTickets[key] + partials[w].passengerTickets[key];
+            merged.passengerTickets[key] = static_cast<std::uint8_t>(std::min(count, 2u));
+        }
+    }
+
+    StationStatistics result;
+    result.byTariff = std::move(merged.byTariff);
+
+    // Итоги по типам вагонов и скидкам - по тарифам, без повторного прохода
+    std::vector<RevenueGroup> vagonGroups = groupTariffTotals(station, result.byTariff, GROUP_BY_VAGON);
+    for (int type = SIT; type <= KUPE; ++type) {
+        result.byVagon[type] = vagonGroups[type].totals;
+    }
+
+    for (RevenueGroup& group : groupTariffTotals(station, result.byTariff, GROUP_BY_DISCOUNT)) {
+        result.discountNames.push_back(std::move(group.name));
+        result.byDiscount.push_back(group.totals);
+    }
+
+    for (size_t key = 0; key < passengerKeyCount; ++key) {
+        if (merged.passengerTickets[key] > 1) {
+            result.multiTicketPassengers.push_back(static_cast<std::uint32_t>(key));
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,56 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "types.h"
+#include "money.h"
+#include "ledger.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Station;
+
+// Признак группировки выручки
+typedef enum {GROUP_BY_TARIFF, GROUP_BY_VAGON, GROUP_BY_DISCOUNT} RevenueGrouping;
+
+// Строка разбивки выручки
+struct RevenueGroup {
+    std::string name;
+    RevenueTotals totals;
+};
+
+// Сведение итогов по ключам тарифов в группы (направление, тип вагона или скидка).
+// Тарифы без продаж дают группы с нулевыми итогами
+std::vector<RevenueGroup> groupTariffTotals(const Station& station,
+                                            const std::vector<RevenueTotals>& byTariff,
+                                            RevenueGrouping grouping);
+
+// Сводная статистика станции
+// Общие итоги не входят: их поддерживает Station (getTotalRevenue, getTicketCount)
+struct StationStatistics {
+    std::vector<RevenueTotals> byTariff;   // по ключу тарифа (Station::getTariffByKey)
+    RevenueTotals byVagon[VAGON_TYPE_COUNT]; // по VagonType
+    std::vector<std::string> discountNames;
+    std::vector<RevenueTotals> byDiscount; // в порядке discountNames
+    std::vector<std::uint32_t> multiTicketPassengers; // ключи пассажиров с несколькими билетами
+};
+
+// Параллельный расчет статистики.
+// Книга продаж делится на непрерывные диапазоны строк, каждый поток за один проход
+// накапливает свои итоги по тарифам и счетчики билетов пассажиров, затем частичные
+// итоги складываются. Суммы целочисленные, поэтому результат не зависит от числа
+// потоков. Итоги по типам вагонов и скидкам сводятся из итогов по тарифам.
+class StatisticsEngine {
+private:
+    unsigned workerCount;
+
+public:
+    // workerCount = 0 - по числу аппаратных потоков
+    explicit StatisticsEngine(unsigned workerCount = 0);
+
+    unsigned getWorkerCount() const;
+
+    StationStatistics compute(const Station& station) const;
+};
+
+#endif // STATISTICS_H
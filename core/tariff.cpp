@@ -1,18 +1,24 @@
 #include "tariff.h"
+#include "station.h"
+#include "pricing.h"
 #include <sstream>
 #include <iomanip>
 
-Tariff::Tariff(const std::string& name, float price, VagonType type,
-               std::unique_ptr<DiscountStrategy> discount)
+Tariff::Tariff(const std::string& name, Money price, VagonType type,
+               DiscountHandle discount)
     : name(name), basePrice(price), vagonType(type),
     discountStrategy(std::move(discount)) {
+    if (!discountStrategy) {
+        discountStrategy = NoDiscount::shared();
+    }
+    updatePriceCache();
 }
 
-std::string Tariff::getName() const {
+const std::string& Tariff::getName() const {
     return name;
 }
 
-float Tariff::getBasePrice() const {
+Money Tariff::getBasePrice() const {
     return basePrice;
 }
 
@@ -20,53 +26,59 @@ VagonType Tariff::getVType() const {
     return vagonType;
 }
 
-DiscountStrategy* Tariff::getDiscount() const {
+const DiscountStrategy* Tariff::getDiscount() const {
     return discountStrategy.get();
 }
 
-DiscountInfo Tariff::getDiscountInfo() const {
-    if (discountStrategy) {
-        return discountStrategy->getDiscountInfo();
-    }
-    return DiscountInfo("Без скидки", 0.0f);
+const DiscountInfo& Tariff::getDiscountInfo() const {
+    return discountStrategy->getDiscountInfo();
 }
 
 void Tariff::setName(const  std::string& newName){
+    // Ключ индекса ссылается на строку name, поэтому снимаем его до изменения
+    if (owner) owner->unindexTariff(this);
     name = newName;
+    if (owner) owner->indexTariff(this);
+    if (owner) owner->onTariffChanged(this);
 }
 
-void Tariff::setBasePrice(float newPrice){
+void Tariff::setBasePrice(Money newPrice){
     basePrice = newPrice;
+    refreshPrice();
 }
 
 void Tariff::setVType(VagonType newType){
     vagonType = newType;
+    refreshPrice();
 }
 
-// Установка скидки из менеджера
-void Tariff::setDiscountFromManager(DiscountManager& manager, const std::string& discountName) {
-    auto discount = manager.getDiscountByName(discountName);
+// Установка скидки
+void Tariff::setDiscount(DiscountHandle discount) {
     if (discount) {
         discountStrategy = std::move(discount);
+        refreshPrice();
     }
 }
 
-// Расчет цены
-float Tariff::calculatePrice(bool withoutDiscount) const {
-    float multiplier = 1.0f;
-    switch (vagonType) {
-    case PLAC: multiplier = 1.5f; break;
-    case KUPE: multiplier = 2.0f; break;
-    case SIT:  multiplier = 1.0f; break;
-    }
+// Установка скидки из менеджера
+void Tariff::setDiscountFromManager(DiscountManager& manager, const std::string& discountName) {
+    setDiscount(manager.getDiscountByName(discountName));
+}
 
-    float price = basePrice * multiplier;
+// Пересчет кэшированной цены
+void Tariff::updatePriceCache() {
+    computePrice(resolvePriceFactors(*this), cachedPrice, cachedFullPrice);
+}
 
-    if (withoutDiscount) {
-        return price;
-    }
+void Tariff::refreshPrice() {
+    Money oldPrice = cachedPrice;
+    updatePriceCache();
+    if (owner) owner->onTariffPriceChanged(this, oldPrice);
+}
 
-    return discountStrategy->applyDiscount(price);
+// Расчет цены (из кэша)
+Money Tariff::calculatePrice(bool withoutDiscount) const {
+    return withoutDiscount ? cachedFullPrice : cachedPrice;
 }
 
 std::string Tariff::getVagonTypeString() const {
@@ -82,12 +94,12 @@ std::string Tariff::getInfo() const {
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(2);
 
-    DiscountInfo discountInfo = getDiscountInfo();
+    const DiscountInfo& discountInfo = getDiscountInfo();
 
     oss << "Направление: " << name << "\n"
         << "Тип вагона: " << getVagonTypeString() << "\n"
-        << "Базовая цена: " << basePrice << "\n"
-        << "Цена с учетом типа: " << calculatePrice(true) << "\n"
+        << "Базовая цена: " << basePrice.toString() << "\n"
+        << "Цена с учетом типа: " << calculatePrice(true).toString() << "\n"
         << "Скидка: " << discountInfo.name
         << " (" << discountInfo.percentage << "%)\n";
 
@@ -95,7 +107,7 @@ std::string Tariff::getInfo() const {
         oss << "Описание: " << discountInfo.description << "\n";
     }
 
-    oss << "Итоговая цена: " << calculatePrice(false);
+    oss << "Итоговая цена: " << calculatePrice(false).toString();
 
     return oss.str();
 }
@@ -3,19 +3,40 @@
 
 #include "types.h"
 #include "discount.h"
+#include "money.h"
 #include <string>
 #include <memory>
 
+class Station;
+
 class Tariff {
 private:
     std::string name;
-    float basePrice;
+    Money basePrice;
     VagonType vagonType;
-    std::unique_ptr<DiscountStrategy> discountStrategy;
+    DiscountHandle discountStrategy;
+
+    // Кэш итоговой цены (со скидкой и без), пересчитывается сеттерами цены,
+    // типа вагона и скидки
+    Money cachedPrice;
+    Money cachedFullPrice;
+
+    void updatePriceCache();
+    // Пересчет кэша и уведомление станции об изменении цены
+    void refreshPrice();
+
+    // Станция, в индексах которой зарегистрирован тариф
+    Station* owner = nullptr;
+    // Числовой ключ тарифа в колоночной книге продаж станции
+    std::uint32_t key = 0;
+    // Позиция тарифа в списке станции
+    std::uint32_t row = 0;
+
+    friend class Station;
 
 public:
-    Tariff(const std::string& name, float price, VagonType type,
-           std::unique_ptr<DiscountStrategy> discount = std::make_unique<NoDiscount>());
+    Tariff(const std::string& name, Money price, VagonType type,
+           DiscountHandle discount = NoDiscount::shared());
 
     // Запрещаем копирование
     Tariff(const Tariff&) = delete;
@@ -27,19 +48,20 @@ public:
 
     virtual ~Tariff() = default;
 
-    std::string getName() const;
-    float getBasePrice() const;
+    const std::string& getName() const;
+    Money getBasePrice() const;
     VagonType getVType() const;
-    DiscountStrategy* getDiscount() const;
-    DiscountInfo getDiscountInfo() const;
+    const DiscountStrategy* getDiscount() const;
+    const DiscountInfo& getDiscountInfo() const;
 
     void setName(const std::string& newName);
-    void setBasePrice(float newPrice);
+    void setBasePrice(Money newPrice);
     void setVType(VagonType newType);
+    void setDiscount(DiscountHandle discount);
     void setDiscountFromManager(DiscountManager& manager, const std::string& discountName);
 
     // Расчет цены
-    float calculatePrice(bool withoutDiscount = false) const;
+    Money calculatePrice(bool withoutDiscount = false) const;
 
     // Информация
     std::string getVagonTypeString() const;
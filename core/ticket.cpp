@@ -1,4 +1,5 @@
 #include "ticket.h"
+#include "station.h"
 #include <sstream>
 #include <iomanip>
 
@@ -6,6 +7,10 @@ Ticket::Ticket(Passenger* pass, Tariff* tariff)
     : passenger(pass), tariff(tariff) {
 }
 
+TicketId Ticket::getId() const {
+    return id;
+}
+
 Passenger* Ticket::getPassenger() const {
     return passenger;
 }
@@ -15,22 +20,26 @@ Tariff* Ticket::getTariff() const {
 }
 
 void Ticket::setPassenger(Passenger* newPass){
+    if (owner) owner->unlinkTicket(this);
     passenger = newPass;
+    if (owner) owner->linkTicket(this);
 }
 
 void Ticket::setTariff(Tariff* newTariff){
+    if (owner) owner->unlinkTicket(this);
     tariff = newTariff;
+    if (owner) owner->linkTicket(this);
 }
 
 int Ticket::getPassportNumber() const {
     return passenger->getPassport();
 }
 
-std::string Ticket::getDestination() const {
+const std::string& Ticket::getDestination() const {
     return tariff->getName();
 }
 
-float Ticket::getPrice(bool withoutDiscount) const {
+Money Ticket::getPrice(bool withoutDiscount) const {
     return tariff->calculatePrice(withoutDiscount);
 }
 
@@ -41,7 +50,7 @@ std::string Ticket::getInfo() const {
         << "Паспорт: " << passenger->getPassport() << "\n"
         << "Направление: " << tariff->getName() << "\n"
         << "Тип вагона: " << tariff->getVagonTypeString() << "\n"
-        << "Стоимость: " << getPrice(false) << " руб.";
+        << "Стоимость: " << getPrice(false).toString() << " руб.";
 
     return oss.str();
 }
@@ -3,16 +3,29 @@
 
 #include "passenger.h"
 #include "tariff.h"
+#include <cstdint>
 #include <memory>
 
+class Station;
+
 class Ticket {
 private:
     Passenger* passenger;
     Tariff* tariff;
+    TicketId id = 0;
+
+    // Станция, в индексах которой зарегистрирован билет
+    Station* owner = nullptr;
+    // Позиции билета в списках билетов его пассажира и его тарифа
+    std::uint32_t passengerSlot = 0;
+    std::uint32_t tariffSlot = 0;
+
+    friend class Station;
 
 public:
     Ticket(Passenger* pass, Tariff* tariff);
 
+    TicketId getId() const;
     Passenger* getPassenger() const;
     Tariff* getTariff() const;
 
@@ -20,8 +33,8 @@ public:
     void setTariff(Tariff* newTariff);
 
     int getPassportNumber() const;
-    std::string getDestination() const;
-    float getPrice(bool whithoutDiscount) const;
+    const std::string& getDestination() const;
+    Money getPrice(bool whithoutDiscount) const;
 
     std::string getInfo() const;
 };
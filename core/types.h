@@ -2,6 +2,9 @@
 #define TYPES_H
 
 #include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
 
 typedef enum {
     SIT,
@@ -9,6 +12,17 @@ typedef enum {
     KUPE
 } VagonType;
 
+// Число типов вагонов; значения из файлов проверяются по нему
+const int VAGON_TYPE_COUNT = KUPE + 1;
+
+inline bool isValidVagonType(int type)
+{
+    return type >= 0 && type < VAGON_TYPE_COUNT;
+}
+
+// Стабильный идентификатор билета (0 - недействительный)
+typedef std::uint64_t TicketId;
+
 struct DiscountInfo {
     std::string name;
     float percentage;
@@ -19,4 +33,31 @@ struct DiscountInfo {
         : name(n), percentage(p), description(d) {}
 };
 
+// Вид записи и тип изменения в уведомлениях Station и DiscountManager
+typedef enum {
+    ENTITY_PASSENGER,
+    ENTITY_TARIFF,
+    ENTITY_TICKET,
+    ENTITY_DISCOUNT
+} EntityKind;
+
+typedef enum {
+    CHANGE_INSERTED,
+    CHANGE_UPDATED,
+    CHANGE_REMOVED,
+    CHANGE_RESET
+} ChangeType;
+
+// Изменение одной записи. row - позиция записи в списке (для удаленной - позиция
+// до удаления), id - ключ пассажира или тарифа, TicketId билета (для скидок 0).
+// При CHANGE_RESET список записей данного вида заменен целиком, row и id не используются
+struct ChangeEvent {
+    EntityKind entity;
+    ChangeType type;
+    size_t row;
+    std::uint64_t id;
+};
+
+typedef std::function<void(const ChangeEvent& event)> ChangeHandler;
+
 #endif // TYPES_H
@@ -1,6 +1,7 @@
 #include "deldialog.h"
 #include "ui_deldialog.h"
 #include "core/discount.h"
+#include "pickermodel.h"
 #include <QMessageBox>
 
 DelDialog::DelDialog(int mode, Station* station, DiscountManager* discountManager, QWidget *parent)
@@ -66,41 +67,22 @@ void DelDialog::populateComboBox()
     ui->delCombo->clear();
 
     switch (currentMode) {
+    // Тарифы, пассажиры и билеты - ленивые списки с поиском
     case 1: // Тарифы
-    {
-        auto tariffs = station->getAllTariffs();
-        for (size_t i = 0; i < tariffs.size(); ++i) {
-            QString displayText = QString("%1 - %2 руб.")
-                                      .arg(QString::fromStdString(tariffs[i]->getName()))
-                                      .arg(tariffs[i]->calculatePrice(false), 0, 'f', 2);
-            ui->delCombo->addItem(displayText, static_cast<int>(i));
+        if (station->getTariffCount()) {
+            PickerModel::setupComboBox(ui->delCombo, PickerModel::TARIFFS, station);
         }
         break;
-    }
     case 2: // Пассажиры
-    {
-        auto passengers = station->getAllPassengers();
-        for (size_t i = 0; i < passengers.size(); ++i) {
-            QString displayText = QString("%1 %2 (паспорт: %3)")
-                                      .arg(QString::fromStdString(passengers[i]->getLastName()))
-                                      .arg(QString::fromStdString(passengers[i]->getFirstName()))
-                                      .arg(passengers[i]->getPassport());
-            ui->delCombo->addItem(displayText, static_cast<int>(i));
+        if (station->getPassengerCount()) {
+            PickerModel::setupComboBox(ui->delCombo, PickerModel::PASSENGERS, station);
         }
         break;
-    }
     case 3: // Билеты
-    {
-        auto tickets = station->getAllTickets();
-        for (size_t i = 0; i < tickets.size(); ++i) {
-            QString displayText = QString("%1 -> %2 - %3 руб.")
-                                      .arg(QString::fromStdString(tickets[i]->getPassenger()->getFullName()))
-                                      .arg(QString::fromStdString(tickets[i]->getDestination()))
-                                      .arg(tickets[i]->getPrice(false), 0, 'f', 2);
-            ui->delCombo->addItem(displayText, static_cast<int>(i));
+        if (station->getTicketCount()) {
+            PickerModel::setupComboBox(ui->delCombo, PickerModel::TICKETS, station);
         }
         break;
-    }
     case 4: // Скидки
     {
         auto discounts = discountManager->getAllDiscounts();
@@ -132,14 +114,21 @@ void DelDialog::onAccept()
         return;
     }
 
-    int selectedIndex = ui->delCombo->currentData().toInt();
+    // Введенный, но не выбранный из подсказок текст сопоставляется с записями
+    if (currentMode != 4 && ui->delCombo->isEnabled() && PickerModel::resolveSelection(ui->delCombo) < 0) {
+        QMessageBox::warning(this, "Ошибка", "Выберите запись из списка");
+        return;
+    }
+
+    QVariant selected = ui->delCombo->currentData();
 
-    if (selectedIndex < 0) {
+    if (selected.toLongLong() < 0) {
         QMessageBox::warning(this, "Ошибка", "Нет данных для удаления");
         return;
     }
 
-    QString itemText = ui->delCombo->currentText();
+    // В списке с поиском текст поля может отличаться от выбранной строки
+    QString itemText = ui->delCombo->itemText(ui->delCombo->currentIndex());
     QString message;
 
     switch (currentMode) {
@@ -161,7 +150,7 @@ void DelDialog::onAccept()
                                                               message, QMessageBox::Yes | QMessageBox::No);
 
     if (reply == QMessageBox::Yes){
-        emit acceptedWithIndex(currentMode, selectedIndex);
+        emit acceptedWithIndex(currentMode, selected);
         accept();
     }
 }
@@ -19,7 +19,8 @@ public:
     ~DelDialog();
 
 signals:
-    void acceptedWithIndex(int mode, int selectedIndex);
+    // Для билетов передается TicketId, для остальных режимов - индекс записи
+    void acceptedWithIndex(int mode, const QVariant& selected);
 
 private slots:
     void onAccept();
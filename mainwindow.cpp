@@ -12,20 +12,46 @@
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
 #include <QList>
+#include <QTimer>
+#include <QSignalBlocker>
+#include <QStyle>
+#include <QFontMetrics>
+
+#include <algorithm>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , journal(&station, &discountManager)
 {
     ui->setupUi(this);
 
     autoMode = false;
 
+    // Снимок данных пишется в фоне, после паузы в изменениях; записанный снимок
+    // включает журнал до номера snapshotSeq
+    backupWriter = new BackupWriter("data.backup", [this]() {
+        snapshotSeq = journal.getLastSeq();
+        return station.serialize(autoMode, true, snapshotSeq);
+    }, this);
+    connect(backupWriter, &BackupWriter::written, this, [this]() {
+        journal.snapshotWritten(snapshotSeq);
+    });
+    connect(backupWriter, &BackupWriter::writeFailed, this, [this]() {
+        showStatusMessage("Не удалось записать бэкап");
+    });
+
     // Настройка моделей
     setupModels();
 
+    passengerSearchTimer = new QTimer(this);
+    passengerSearchTimer->setSingleShot(true);
+    passengerSearchTimer->setInterval(PASSENGER_SEARCH_DELAY_MS);
+    connect(passengerSearchTimer, &QTimer::timeout, this, &MainWindow::refreshPassengersTable);
+
     // Обновление таблиц
     refreshAllTables();
+    wasSaved = false;
 
     // Подключение менеджера скидок к станции
     station.connectDiscountManager(&discountManager);
@@ -46,162 +72,252 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    if (autoMode) backupWriter->flush();
     delete ui;
 }
 
 void MainWindow::setupModels()
 {
+    // Модели таблиц сортируют строки сами, без QSortFilterProxyModel
+
     // Модель для тарифов
-    tariffsModel = new QStandardItemModel(this);
-    tariffsProxyModel = new QSortFilterProxyModel(this);
-    tariffsModel->setHorizontalHeaderLabels({"Название", "Тип вагона", "Базовая цена", "Скидка", "Итоговая цена"});
-    tariffsProxyModel->setSourceModel(tariffsModel);
-    tariffsProxyModel->setSortRole(Qt::EditRole);
-    ui->tableTariffs->setModel(tariffsProxyModel);
+    tariffsModel = new TariffTableModel(&station, this);
+    ui->tableTariffs->setModel(tariffsModel);
     ui->tableTariffs->horizontalHeader()->setStretchLastSection(true);
 
     // Модель для скидок
-    discountsModel = new QStandardItemModel(this);
-    discountsProxyModel = new QSortFilterProxyModel(this);
-    discountsModel->setHorizontalHeaderLabels({"Название", "Размер, %", "Описание"});
-    discountsProxyModel->setSourceModel(discountsModel);
-    discountsProxyModel->setSortRole(Qt::EditRole);
-    ui->tableDiscounts->setModel(discountsProxyModel);
+    discountsModel = new DiscountTableModel(&discountManager, this);
+    ui->tableDiscounts->setModel(discountsModel);
     ui->tableDiscounts->horizontalHeader()->setStretchLastSection(true);
 
     // Модель для пассажиров
-    passengersModel = new QStandardItemModel(this);
-    passesProxyModel = new QSortFilterProxyModel(this);
-    passengersModel->setHorizontalHeaderLabels({"Паспорт", "Фамилия", "Имя"});
-    passesProxyModel->setSourceModel(passengersModel);
-    passesProxyModel->setSortRole(Qt::EditRole);
-    ui->tablePasses->setModel(passesProxyModel);
+    passengersModel = new PassengerTableModel(&station, this);
+    ui->tablePasses->setModel(passengersModel);
     ui->tablePasses->horizontalHeader()->setStretchLastSection(true);
 
     // Модель для билетов
-    ticketsModel = new QStandardItemModel(this);
-    ticketsProxyModel = new QSortFilterProxyModel(this);
-    ticketsModel->setHorizontalHeaderLabels({"Паспорт", "Пассажир", "Направление", "Стоимость"});
-    ticketsProxyModel->setSourceModel(ticketsModel);
-    ticketsProxyModel->setSortRole(Qt::EditRole);
-    ui->tableTickets->setModel(ticketsProxyModel);
+    ticketsModel = new TicketTableModel(&station, this);
+    ui->tableTickets->setModel(ticketsModel);
     ui->tableTickets->horizontalHeader()->setStretchLastSection(true);
+
+    // Пассажиры и билеты загружаются в представление порциями по мере прокрутки
+    passengersModel->setFetchBatchSize(FETCH_BATCH_SIZE);
+    ticketsModel->setFetchBatchSize(FETCH_BATCH_SIZE);
+
+    // Модель для разбивки выручки
+    breakdownModel = new QStandardItemModel(this);
+    breakdownProxyModel = new QSortFilterProxyModel(this);
+    breakdownModel->setHorizontalHeaderLabels({"Группа", "Выручка", "Убыток по скидкам", "Билетов"});
+    breakdownProxyModel->setSourceModel(breakdownModel);
+    breakdownProxyModel->setSortRole(Qt::EditRole);
+    ui->tableBreakdown->setModel(breakdownProxyModel);
+    ui->tableBreakdown->horizontalHeader()->setStretchLastSection(true);
+
+    // Таблицы обновляются по уведомлениям об изменении отдельных записей
+    station.addChangeHandler([this](const ChangeEvent& event) { onDataChanged(event); });
+    discountManager.addChangeHandler([this](const ChangeEvent& event) { onDataChanged(event); });
 }
 
 void MainWindow::refreshTariffsTable()
 {
-    tariffsModel->removeRows(0, tariffsModel->rowCount());
-
-    auto tariffs = station.getAllTariffs();
-    for (size_t i = 0; i < tariffs.size(); ++i) {
-        QList<QStandardItem*> row;
-        row << new QStandardItem(QString::fromStdString(tariffs[i]->getName()));
-        row << new QStandardItem(QString::fromStdString(tariffs[i]->getVagonTypeString()));
-
-        double basePrice = tariffs[i]->getBasePrice();
-        QStandardItem* baseItem = new QStandardItem();
-        baseItem->setText(QString::number(basePrice, 'f', 2));
-        baseItem->setData(basePrice, Qt::EditRole);
-        row << baseItem;
+    markTableClean(TABLE_TARIFFS);
+    tariffsModel->reload();
+    resizeColumnsBySample(ui->tableTariffs, tariffsModel);
+}
 
-        auto discountInfo = tariffs[i]->getDiscount()->getDiscountInfo();
-        row << new QStandardItem(QString("%1 (%2%)")
-                                     .arg(QString::fromStdString(discountInfo.name))
-                                     .arg(discountInfo.percentage, 0, 'f', 1));
+void MainWindow::refreshDiscountsTable()
+{
+    markTableClean(TABLE_DISCOUNTS);
+    discountsModel->reload();
+    resizeColumnsBySample(ui->tableDiscounts, discountsModel);
+}
 
-        double finalPrice = tariffs[i]->calculatePrice(false);
-        QStandardItem* finalItem = new QStandardItem();
-        finalItem->setText(QString::number(finalPrice, 'f', 2));
-        finalItem->setData(finalPrice, Qt::EditRole);
-        row << finalItem;
+void MainWindow::refreshPassengersTable()
+{
+    markTableClean(TABLE_PASSENGERS);
+    passengersModel->setSearchText(ui->passengerSearchEdit->text());
+    resizeColumnsBySample(ui->tablePasses, passengersModel);
+}
 
-        tariffsModel->appendRow(row);
-    }
-    ui->tableTariffs->resizeColumnsToContents();
+void MainWindow::refreshTicketsTable()
+{
+    markTableClean(TABLE_TICKETS);
+    ticketsModel->reload();
+    resizeColumnsBySample(ui->tableTickets, ticketsModel);
 }
 
-void MainWindow::refreshDiscountsTable()
+void MainWindow::refreshBreakdownTable()
 {
-    discountsModel->removeRows(0, discountsModel->rowCount());
+    markTableClean(TABLE_BREAKDOWN);
+    breakdownModel->removeRows(0, breakdownModel->rowCount());
 
-    auto discounts = discountManager.getAllDiscounts();
-    for (const auto& discount : discounts) {
+    RevenueGrouping grouping = static_cast<RevenueGrouping>(ui->breakdownCombo->currentIndex());
+    std::vector<RevenueGroup> groups = station.getRevenueBreakdown(grouping);
+
+    for (const RevenueGroup& group : groups) {
         QList<QStandardItem*> row;
-        row << new QStandardItem(QString::fromStdString(discount.name));
+        row << new QStandardItem(QString::fromStdString(group.name));
 
-        double perc = discount.percentage;
-        QStandardItem* baseItem = new QStandardItem();
-        baseItem->setText(QString::number(perc, 'f', 2));
-        baseItem->setData(perc, Qt::EditRole);
-        row << baseItem;
+        QStandardItem* revenueItem = new QStandardItem();
+        revenueItem->setText(QString::fromStdString(group.totals.revenue.toString()));
+        revenueItem->setData(group.totals.revenue.toRubles(), Qt::EditRole);
+        row << revenueItem;
 
-        row << new QStandardItem(QString::fromStdString(discount.description));
+        QStandardItem* lossItem = new QStandardItem();
+        Money loss = group.totals.getDiscountLoss();
+        lossItem->setText(QString::fromStdString(loss.toString()));
+        lossItem->setData(loss.toRubles(), Qt::EditRole);
+        row << lossItem;
 
-        discountsModel->appendRow(row);
-    }
+        QStandardItem* countItem = new QStandardItem();
+        countItem->setData(static_cast<qulonglong>(group.totals.ticketCount), Qt::EditRole);
+        row << countItem;
 
-    ui->tableDiscounts->resizeColumnsToContents();
+        breakdownModel->appendRow(row);
+    }
+    ui->tableBreakdown->resizeColumnsToContents();
 }
 
-void MainWindow::refreshPassengersTable()
+// Ширина столбцов по выборке строк, равномерно распределенных по всем записям
+// (в т.ч. еще не загруженным), без обхода всей таблицы
+void MainWindow::resizeColumnsBySample(QTableView* view, const StationTableModel* model)
 {
-    passengersModel->removeRows(0, passengersModel->rowCount());
+    const int sampleSize = 200;
+    int total = model->totalRowCount();
+    int step = std::max(1, total / sampleSize);
+    int padding = 2 * (view->style()->pixelMetric(QStyle::PM_FocusFrameHMargin, nullptr, view) + 1) + 1;
+    QFontMetrics metrics = view->fontMetrics();
+
+    for (int column = 0; column < model->columnCount(); ++column) {
+        int width = view->horizontalHeader()->sectionSizeHint(column);
+        for (int row = 0; row < total; row += step) {
+            QString text = model->cellData(row, column, Qt::DisplayRole).toString();
+            width = std::max(width, metrics.horizontalAdvance(text) + padding);
+        }
+        view->setColumnWidth(column, width);
+    }
+}
 
-    auto passengers = station.getAllPassengers();
-    for (size_t i = 0; i < passengers.size(); ++i) {
-        QList<QStandardItem*> row;
-        int passport = passengers[i]->getPassport();
-        QStandardItem* baseItem = new QStandardItem();
-        baseItem->setText(QString::number(passport, 'i', 0));
-        baseItem->setData(passport, Qt::EditRole);
-        row << baseItem;
+// Видимые таблицы перестраиваются в конце прохода цикла событий,
+// остальные - при показе своей вкладки
+void MainWindow::refreshAllTables()
+{
+    invalidateTable(TABLE_TARIFFS);
+    invalidateTable(TABLE_DISCOUNTS);
+    invalidateTable(TABLE_PASSENGERS);
+    invalidateTable(TABLE_TICKETS);
+    invalidateTable(TABLE_BREAKDOWN);
+    schedulePendingWork();
+}
 
-        row << new QStandardItem(QString::fromStdString(passengers[i]->getLastName()));
-        row << new QStandardItem(QString::fromStdString(passengers[i]->getFirstName()));
+void MainWindow::refreshVisibleTables()
+{
+    unsigned visible = visibleTables();
+    unsigned rebuild = dirtyTables & visible;
+    unsigned resize = resizeTables & visible & ~rebuild;
+
+    if (rebuild & TABLE_TARIFFS) refreshTariffsTable();
+    if (rebuild & TABLE_DISCOUNTS) refreshDiscountsTable();
+    if (rebuild & TABLE_PASSENGERS) refreshPassengersTable();
+    if (rebuild & TABLE_TICKETS) refreshTicketsTable();
+    if (rebuild & TABLE_BREAKDOWN) refreshBreakdownTable();
+
+    if (resize & TABLE_TARIFFS) resizeColumnsBySample(ui->tableTariffs, tariffsModel);
+    if (resize & TABLE_DISCOUNTS) resizeColumnsBySample(ui->tableDiscounts, discountsModel);
+    if (resize & TABLE_PASSENGERS) resizeColumnsBySample(ui->tablePasses, passengersModel);
+    if (resize & TABLE_TICKETS) resizeColumnsBySample(ui->tableTickets, ticketsModel);
+    resizeTables &= ~resize;
+}
 
-        passengersModel->appendRow(row);
+unsigned MainWindow::visibleTables() const
+{
+    QWidget* tab = ui->tabWidget->currentWidget();
+    if (tab == ui->InfoTab) {
+        return TABLE_TARIFFS | TABLE_DISCOUNTS | TABLE_PASSENGERS | TABLE_TICKETS;
+    }
+    if (tab == ui->FeaturesTab) {
+        return TABLE_BREAKDOWN;
     }
-    ui->tablePasses->resizeColumnsToContents();
+    return 0;
 }
 
-void MainWindow::refreshTicketsTable()
+StationTableModel* MainWindow::tableModel(TableFlag table) const
 {
-    ticketsModel->removeRows(0, ticketsModel->rowCount());
+    switch (table) {
+    case TABLE_TARIFFS:    return tariffsModel;
+    case TABLE_DISCOUNTS:  return discountsModel;
+    case TABLE_PASSENGERS: return passengersModel;
+    case TABLE_TICKETS:    return ticketsModel;
+    case TABLE_BREAKDOWN:  return nullptr;
+    }
+    return nullptr;
+}
 
-    auto tickets = station.getAllTickets();
-    for (size_t i = 0; i < tickets.size(); ++i) {
-        QList<QStandardItem*> row;
+// Модель устаревшей таблицы очищается и до перестройки не получает уведомлений,
+// поэтому не обращается к уже удаленным записям
+void MainWindow::invalidateTable(TableFlag table)
+{
+    if (dirtyTables & table) return;
+    dirtyTables |= table;
+    if (StationTableModel* model = tableModel(table)) {
+        model->detach();
+    }
+}
 
-        QStandardItem* baseItem = new QStandardItem();
-        int passport = tickets[i]->getPassportNumber();
-        baseItem->setText(QString::number(passport, 'i', 0));
-        baseItem->setData(passport, Qt::EditRole);
-        row << baseItem;
+void MainWindow::markTableClean(TableFlag table)
+{
+    dirtyTables &= ~table;
+    resizeTables &= ~table;
+}
 
-        row << new QStandardItem(QString::fromStdString(tickets[i]->getPassenger()->getFullName()));
-        row << new QStandardItem(QString::fromStdString(tickets[i]->getDestination()));
+// Изменение одной записи обновляет только ее строку (и зависящие от нее столбцы)
+// в видимых таблицах; скрытые таблицы помечаются устаревшими. Разбивка выручки
+// и автосохранение выполняются один раз после серии изменений
+void MainWindow::onDataChanged(const ChangeEvent& event)
+{
+    journal.record(event);
 
-        QStandardItem* baseItem2 = new QStandardItem();
-        double basePrice = tickets[i]->getPrice(false);
-        baseItem2->setText(QString::number(basePrice, 'f', 2));
-        baseItem2->setData(basePrice, Qt::EditRole);
-        row << baseItem2;
+    unsigned visible = visibleTables();
+    for (TableFlag table : {TABLE_TARIFFS, TABLE_DISCOUNTS, TABLE_PASSENGERS, TABLE_TICKETS}) {
+        StationTableModel* model = tableModel(table);
+        if ((dirtyTables & table) || !model->dependsOn(event.entity)) continue;
 
-        ticketsModel->appendRow(row);
+        if (visible & table) {
+            model->applyChange(event);
+            if (event.type == CHANGE_RESET) resizeTables |= table;
+        } else {
+            invalidateTable(table);
+        }
     }
-    ui->tableTickets->resizeColumnsToContents();
+
+    if (event.entity != ENTITY_PASSENGER) invalidateTable(TABLE_BREAKDOWN);
+    wasSaved = false;
+
+    schedulePendingWork();
 }
 
-void MainWindow::refreshAllTables()
+void MainWindow::schedulePendingWork()
 {
-    refreshTariffsTable();
-    refreshPassengersTable();
-    refreshTicketsTable();
-    refreshDiscountsTable();
+    if (pendingWorkScheduled) return;
+    pendingWorkScheduled = true;
+    QTimer::singleShot(0, this, [this]() { flushPendingWork(); });
+}
 
-    wasSaved = false;
+void MainWindow::flushPendingWork()
+{
+    pendingWorkScheduled = false;
+
+    refreshVisibleTables();
 
-    if(autoMode) station.saveToFile("data.backup", true, true);
+    // Операции уже записаны в журнал; снимок нужен сразу только после сброса данных,
+    // но и тогда он пишется в фоне: журнал не очищается, пока снимок не записан
+    if (autoMode) {
+        if (journal.isSnapshotNeeded()) {
+            backupWriter->start();
+        } else if (journal.getRecordCount() >= JOURNAL_COMPACTION_RECORDS) {
+            backupWriter->schedule();
+        }
+    }
 }
 
 void MainWindow::showStatusMessage(const QString& message, int timeout)
@@ -221,42 +337,37 @@ bool MainWindow::validatePerc(float perc) const
     return perc > 0.0f && perc <= 100.0f;
 }
 
-bool MainWindow::validatePrice(const QString& priceStr, float& price) const
+bool MainWindow::validatePrice(const QString& priceStr, Money& price) const
 {
-    bool ok;
-    price = priceStr.toFloat(&ok);
-    return ok && price > 0 && price <= 10000;
+    bool ok = Money::parse(priceStr.toStdString(), price);
+    return ok && price > Money() && price <= Money(1000000);
 }
 
-QString MainWindow::getSelectedTariffName() const
+Tariff* MainWindow::getSelectedTariff() const
 {
     QModelIndexList selection = ui->tableTariffs->selectionModel()->selectedRows();
     if (!selection.isEmpty()) {
-        int row = selection.first().row();
-        return tariffsModel->item(row, 0)->text();
+        return tariffsModel->tariffAt(selection.first().row());
     }
-    return QString();
+    return nullptr;
 }
 
-int MainWindow::getSelectedPassengerPassport() const
+Passenger* MainWindow::getSelectedPassenger() const
 {
     QModelIndexList selection = ui->tablePasses->selectionModel()->selectedRows();
     if (!selection.isEmpty()) {
-        int row = selection.first().row();
-        bool ok;
-        int passport = passengersModel->item(row, 0)->text().toInt(&ok);
-        return ok ? passport : -1;
+        return passengersModel->passengerAt(selection.first().row());
     }
-    return -1;
+    return nullptr;
 }
 
-int MainWindow::getSelectedTicketIndex() const
+TicketId MainWindow::getSelectedTicketId() const
 {
     QModelIndexList selection = ui->tableTickets->selectionModel()->selectedRows();
     if (!selection.isEmpty()) {
-        return selection.first().row();
+        return ticketsModel->ticketAt(selection.first().row())->getId();
     }
-    return -1;
+    return 0;
 }
 
 bool MainWindow::addPassenger(const QVariantMap& data)
@@ -286,11 +397,11 @@ bool MainWindow::addPassenger(const QVariantMap& data)
         return false;
     }
 
-    station.addPassenger(std::make_unique<Passenger>(
+    station.addPassenger(
         passportNum,
         firstName.toStdString(),
         lastName.toStdString()
-        ));
+        );
 
     return true;
 }
@@ -303,7 +414,7 @@ bool MainWindow::addTariff(const QVariantMap& data)
     QString discountName = data.value("discountName").toString();
     auto discount = discountManager.getDiscountByName(discountName.toStdString());
 
-    float price;
+    Money price;
     if (!validatePrice(priceStr, price)) {
         QMessageBox::warning(this, "Ошибка", "Некорректная цена (0-10000)");
         return false;
@@ -323,12 +434,12 @@ bool MainWindow::addTariff(const QVariantMap& data)
     if (vagonTypeStr == "PLAC") vagonType = PLAC;
     else if (vagonTypeStr == "KUPE") vagonType = KUPE;
 
-    station.addTariff(std::make_unique<Tariff>(
+    station.addTariff(
         name.toStdString(),
         price,
         vagonType,
         std::move(discount)
-        ));
+        );
 
     return true;
 }
@@ -348,7 +459,7 @@ bool MainWindow::addTicket(const QVariantMap& data)
 
     auto tickets = station.getTicketsByPassport(passenger->getPassport());
     for (const auto& ticket : tickets) {
-        if (ticket->getDestination() == tariff->getName()) {
+        if (ticket->getTariff() == tariff) {
             QMessageBox::warning(this, "Ошибка", "У пассажира уже есть билет на это направление");
             return false;
         }
@@ -406,9 +517,9 @@ bool MainWindow::deleteTariff(const QString& name)
     }
 }
 
-bool MainWindow::deleteTicket(int index)
+bool MainWindow::deleteTicket(TicketId id)
 {
-    if (station.removeTicket(index)) {
+    if (station.removeTicket(id)) {
         showStatusMessage("Билет удален");
         return true;
     } else {
@@ -496,93 +607,53 @@ void MainWindow::on_editDataButton_clicked()
         }
     }
 
-    int row = selection.first().row();
     QMap<QString, QString> data;
 
     bool success = false;
 
     switch (editMode) {
     case 1: { // Тариф
-        data["name"] = tariffsModel->item(row, 0)->text();
-        data["price"] = tariffsModel->item(row, 2)->text();
-        QString vagon = tariffsModel->item(row, 1)->text();;
-        if (vagon == "Сидячий") vagon = "0";
-        else if (vagon == "Плацкарт") vagon = "1";
-        else vagon = "2";
-        data["vtype"] = vagon;
-        auto discounts = discountManager.getAllDiscounts();
+        Tariff* tariff = tariffsModel->tariffAt(selection.first().row());
+        data["name"] = QString::fromStdString(tariff->getName());
+        data["price"] = QString::fromStdString(tariff->getBasePrice().toString());
+        data["vtype"] = QString::number(tariff->getVType());
+
         int index = 0;
-        for (const auto& d : discounts) {
-            QString tname = tariffsModel->item(row, 3)->text();
-            QStringList tokens = tname.split(" ");
-            QString currname = "";
-            for (int i = 0; i < tokens.size()-1; ++i) {
-                currname+=" "+tokens[i];
-            }
-            if (" "+d.name == currname.toStdString()) break;
+        for (size_t i = 0; i < discountManager.getDiscountCount(); ++i) {
+            if (discountManager.getDiscountByIndex(i)->getDiscountName() == tariff->getDiscountInfo().name) break;
             index++;
         }
         data["discindex"] = QString("%1").arg(index);
-
-        auto tariffs = station.getAllTariffs();
-        index = 0;
-        for (const auto& t : tariffs) {
-            if (t->getName() == data["name"]) break;
-            index++;
-        }
-        data["selfindex"] = QString("%1").arg(index);
+        data["selfindex"] = QString::number(station.getTariffRow(tariff));
         success = true;
         break;
     }
     case 2: { // Пассажир
-        data["lname"] = passengersModel->item(row, 1)->text();
-        data["fname"] = passengersModel->item(row, 2)->text();
-        data["passp"] = passengersModel->item(row, 0)->text();
-
-        auto passes = station.getAllPassengers();
-        int index = 0;
-        for (const auto& p : passes) {
-            if (QString("%1").arg(p->getPassport()) == data["passp"]) break;
-            index++;
-        }
-        data["selfindex"] = QString("%1").arg(index);
+        Passenger* passenger = passengersModel->passengerAt(selection.first().row());
+        data["lname"] = QString::fromStdString(passenger->getLastName());
+        data["fname"] = QString::fromStdString(passenger->getFirstName());
+        data["passp"] = QString::number(passenger->getPassport());
+        data["selfindex"] = QString::number(station.getPassengerRow(passenger));
         success = true;
         break;
     }
     case 3: { // Билет
-        auto passes = station.getAllPassengers();
-        int index = 0;
-        for (const auto& p : passes) {
-            if (QString("%1").arg(p->getPassport()) == ticketsModel->item(row, 0)->text()) break;
-            index++;
-        }
-        data["passindex"]  = QString("%1").arg(index);
-        auto tariffs = station.getAllTariffs();
-        index = 0;
-        for (const auto& t : tariffs) {
-            if (QString("%1").arg(t->getName()) == ticketsModel->item(row, 2)->text()) break;
-            index++;
-        }
-        data["tariffindex"]  = QString("%1").arg(index);
-
-        auto tickets = station.getAllTickets();
-        index = 0;
-        for (const auto& t : tickets) {
-            if (t->getTariff()->getName() == ticketsModel->item(row, 2)->text() && QString("%1").arg(t->getPassportNumber()) == ticketsModel->item(row, 0)->text()) break;
-            index++;
-        }
-        data["selfindex"] = QString("%1").arg(index);
+        Ticket* ticket = ticketsModel->ticketAt(selection.first().row());
+        data["passindex"] = QString::number(station.getPassengerRow(ticket->getPassenger()));
+        data["tariffindex"] = QString::number(station.getTariffRow(ticket->getTariff()));
+        data["selfindex"] = QString::number(ticket->getId());
         success = true;
         break;
     }
     case 4: { // Скидка
-        data["name"] = discountsModel->item(row, 0)->text();
-        data["perc"] = discountsModel->item(row, 1)->text();
-        data["discr"] = discountsModel->item(row, 2)->text();
-        auto discounts = discountManager.getAllDiscounts();
+        DiscountHandle discount = discountsModel->discountAt(selection.first().row());
+        data["name"] = QString::fromStdString(discount->getDiscountName());
+        data["perc"] = QString::number(discount->getDiscountPercentage(), 'f', 2);
+        data["discr"] = QString::fromStdString(discount->getDiscountDescription());
+
         int index = 0;
-        for (const auto& d : discounts) {
-            if (QString("%1").arg(d.name) == data["name"]) break;
+        for (size_t i = 0; i < discountManager.getDiscountCount(); ++i) {
+            if (discountManager.getDiscountByIndex(i) == discount) break;
             index++;
         }
         data["selfindex"] = QString("%1").arg(index);
@@ -624,7 +695,6 @@ void MainWindow::onAddingDialogAccepted(int mode, QString selfindex, const QVari
     }
 
     if (success) {
-        refreshAllTables();
         showStatusMessage("Данные успешно добавлены");
     }
 }
@@ -635,12 +705,18 @@ void MainWindow::onEditDialogAccepted(int mode, QString selfindex, const QVarian
 
     switch (mode) {
     case 1: { // Тариф
-        if (station.getTariffByName(data["name"].toString().toStdString()) && station.getTariffAt(selfindex.toInt())->getName() != data["name"].toString()) {
+        Tariff* existing = station.getTariffByName(data["name"].toString().toStdString());
+        if (existing && existing != station.getTariffAt(selfindex.toInt())) {
             QMessageBox::warning(this, "Ошибка", "Тариф с таким названием уже существует");
             break;
         }
+        Money price;
+        if (!validatePrice(data["price"].toString().trimmed(), price)) {
+            QMessageBox::warning(this, "Ошибка", "Некорректная цена (0-10000)");
+            break;
+        }
         station.getTariffAt(selfindex.toInt())->setName(data["name"].toString().toStdString());
-        station.getTariffAt(selfindex.toInt())->setBasePrice(data["price"].toFloat());
+        station.getTariffAt(selfindex.toInt())->setBasePrice(price);
         VagonType vagon;
         std::string vdata = data["vagonType"].toString().toStdString();
         if (vdata == "SIT") vagon = SIT;
@@ -664,34 +740,41 @@ void MainWindow::onEditDialogAccepted(int mode, QString selfindex, const QVarian
     }
     case 3: { // Билет
         auto tickets = station.getTicketsByPassport(station.getPassengerAt(data["passengerIndex"].toInt())->getPassport());
+        Tariff* tariff = station.getTariffAt(data["tariffIndex"].toInt());
         bool stop = false;
         for (const auto& ticket : tickets) {
-            if (ticket->getDestination() == station.getTariffAt(data["tariffIndex"].toInt())->getName()) {
+            if (ticket->getTariff() == tariff) {
                 QMessageBox::warning(this, "Ошибка", "У пассажира уже есть билет на это направление");
                 stop = true;
                 break;
             }
         }
         if (stop) break;
-        (*station.getTicketAt(selfindex.toInt())).setPassenger(station.getPassengerAt(data["passengerIndex"].toInt()));
-        (*station.getTicketAt(selfindex.toInt())).setTariff(station.getTariffAt(data["tariffIndex"].toInt()));
+        Ticket* edited = station.getTicket(selfindex.toULongLong());
+        if (!edited) {
+            QMessageBox::warning(this, "Ошибка", "Билет не найден");
+            break;
+        }
+        edited->setPassenger(station.getPassengerAt(data["passengerIndex"].toInt()));
+        edited->setTariff(tariff);
         success = true;
         break;
     }
     case 4: { // Скидка
-        if (discountManager.getDiscountByName(data["name"].toString().toStdString()) && discountManager.getDiscountByIndex(selfindex.toInt())->getDiscountName() != data["name"].toString()) {
+        DiscountHandle edited = discountManager.getDiscountByIndex(selfindex.toInt());
+        DiscountHandle existing = discountManager.getDiscountByName(data["name"].toString().toStdString());
+        if (!edited || (existing && existing != edited)) {
             QMessageBox::warning(this, "Ошибка", "Скидка с таким названием уже существует");
             break;
         }
         DiscountInfo info = DiscountInfo(data["name"].toString().toStdString(), data["perc"].toFloat(), data["discr"].toString().toStdString());
-        discountManager.editDiscount(data["name"].toString().toStdString(), info);
-        success = true;
+        // Новая версия скидки сразу применяется ко всем тарифам, которые на нее ссылаются
+        success = discountManager.editDiscount(edited->getDiscountName(), info);
         break;
     }
     }
 
     if (success) {
-        refreshAllTables();
         showStatusMessage("Данные успешно изменены");
     }
 }
@@ -718,16 +801,16 @@ void MainWindow::on_confirmDel_clicked()
     dialog->exec();
 }
 
-void MainWindow::onDelDialogAccepted(int mode, int selectedIndex)
+void MainWindow::onDelDialogAccepted(int mode, const QVariant& selected)
 {
-    bool success = false;
+    int selectedIndex = selected.toInt();
 
     switch (mode) {
     case 1: // Тариф
         if (selectedIndex >= 0 && selectedIndex < station.getTariffCount()) {
             auto tariff = station.getTariffAt(selectedIndex);
             if (tariff) {
-                success = deleteTariff(QString::fromStdString(tariff->getName()));
+                deleteTariff(QString::fromStdString(tariff->getName()));
             }
         }
         break;
@@ -736,28 +819,24 @@ void MainWindow::onDelDialogAccepted(int mode, int selectedIndex)
         if (selectedIndex >= 0 && selectedIndex < station.getPassengerCount()) {
             auto passenger = station.getPassengerAt(selectedIndex);
             if (passenger) {
-                success = deletePassenger(passenger->getPassport());
+                deletePassenger(passenger->getPassport());
             }
         }
         break;
 
     case 3: // Билет
-        success = deleteTicket(selectedIndex);
+        deleteTicket(selected.toULongLong());
         break;
 
     case 4: // Скидка
         if (selectedIndex >= 0 && selectedIndex < discountManager.getDiscountCount()) {
             auto discount = discountManager.getDiscountByIndex(selectedIndex);
             if (discount) {
-                success = deleteDiscount(QString::fromStdString(discount->getDiscountName()));
+                deleteDiscount(QString::fromStdString(discount->getDiscountName()));
             }
         }
         break;
     }
-
-    if (success) {
-        refreshAllTables();
-    }
 }
 
 void MainWindow::on_ticketByPassButton_clicked()
@@ -773,10 +852,9 @@ void MainWindow::on_ticketByPassButton_clicked()
         return;
     }
 
-    int row = selection.first().row();
-    int passport = passengersModel->item(row, 0)->text().toInt();
+    Passenger* passenger = passengersModel->passengerAt(selection.first().row());
 
-    auto tickets = station.getTicketsByPassport(passport);
+    auto tickets = station.getTicketsByPassport(passenger->getPassport());
 
     if (tickets.empty()) {
         QMessageBox::information(this, "Информация", "У выбранного пассажира нет купленных билетов");
@@ -784,19 +862,19 @@ void MainWindow::on_ticketByPassButton_clicked()
     }
 
     QString info = QString("Билеты пассажира %1 %2:\n\n")
-                       .arg(passengersModel->item(row, 1)->text())
-                       .arg(passengersModel->item(row, 2)->text());
+                       .arg(QString::fromStdString(passenger->getLastName()))
+                       .arg(QString::fromStdString(passenger->getFirstName()));
 
-    float total = 0;
+    Money total;
     for (size_t i = 0; i < tickets.size(); ++i) {
         info += QString("%1. %2 - %3 руб.\n")
                     .arg(i + 1)
                     .arg(QString::fromStdString(tickets[i]->getDestination()))
-                    .arg(tickets[i]->getPrice(false), 0, 'f', 2);
+                    .arg(QString::fromStdString(tickets[i]->getPrice(false).toString()));
         total += tickets[i]->getPrice(false);
     }
 
-    info += QString("\nОбщая стоимость: %1 руб.").arg(total, 0, 'f', 2);
+    info += QString("\nОбщая стоимость: %1 руб.").arg(QString::fromStdString(total.toString()));
 
     QMessageBox::information(this, "Билеты пассажира", info);
 }
@@ -814,8 +892,8 @@ void MainWindow::on_passesByTariffButton_clicked()
         return;
     }
 
-    int row = selection.first().row();
-    QString tariffName = tariffsModel->item(row, 0)->text();
+    Tariff* tariff = tariffsModel->tariffAt(selection.first().row());
+    QString tariffName = QString::fromStdString(tariff->getName());
 
     auto tickets = station.getTicketsByTariff(tariffName.toStdString());
 
@@ -826,10 +904,12 @@ void MainWindow::on_passesByTariffButton_clicked()
 
     QString info = QString("Пассажиры по тарифу \"%1\":\n\n").arg(tariffName);
 
+    std::string fullName;
     for (size_t i = 0; i < tickets.size(); ++i) {
+        tickets[i]->getPassenger()->formatFullName(fullName);
         info += QString("%1. %2 (паспорт: %3)\n")
                     .arg(i + 1)
-                    .arg(QString::fromStdString(tickets[i]->getPassenger()->getFullName()))
+                    .arg(QString::fromStdString(fullName))
                     .arg(tickets[i]->getPassportNumber());
     }
 
@@ -840,16 +920,56 @@ void MainWindow::on_passesByTariffButton_clicked()
 
 void MainWindow::on_totalRevenueButton_clicked()
 {
-    float total = station.getTotalRevenue(false);
-    float discounts = station.getTotalRevenue(true)-total;
+    // Итоги поддерживаются станцией при каждом изменении, разбивки считает движок статистики
+    Money total = station.getTotalRevenue(false);
+    Money fullTotal = station.getTotalRevenue(true);
+
+    QString info = QString("Выручка всего: %1\n").arg(QString::fromStdString(total.toString()));
+    info += QString("Без учёта скидок: %1\n").arg(QString::fromStdString(fullTotal.toString()));
+    info += QString("Сумма убытка по скидкам: %1\n").arg(QString::fromStdString((fullTotal - total).toString()));
+    info += QString("Продано билетов: %1\n").arg(station.getTicketCount());
+
+    StationStatistics stats = statisticsEngine.compute(station);
+    info += QString("Пассажиров с несколькими билетами: %1\n").arg(stats.multiTicketPassengers.size());
+
+    const char* vagonNames[] = {"Сидячий", "Плацкарт", "Купе"};
+    info += "\nПо типам вагонов:\n";
+    for (int type = SIT; type <= KUPE; ++type) {
+        info += QString("%1: %2 (билетов: %3)\n")
+                    .arg(vagonNames[type])
+                    .arg(QString::fromStdString(stats.byVagon[type].revenue.toString()))
+                    .arg(stats.byVagon[type].ticketCount);
+    }
 
-    QString info = QString("Выручка всего: %1\n").arg(total);
-    info += QString("Без учёта скидок: %1\n").arg(total+discounts);
-    info += QString("Сумма убытка по скидкам: %1").arg(discounts);
+    info += "\nПо скидкам:\n";
+    for (size_t i = 0; i < stats.discountNames.size(); ++i) {
+        info += QString("%1: %2 (билетов: %3)\n")
+                    .arg(QString::fromStdString(stats.discountNames[i]))
+                    .arg(QString::fromStdString(stats.byDiscount[i].revenue.toString()))
+                    .arg(stats.byDiscount[i].ticketCount);
+    }
 
     QMessageBox::information(this, "Финансовая сводка", info);
 }
 
+void MainWindow::on_breakdownCombo_currentIndexChanged(int index)
+{
+    Q_UNUSED(index);
+    refreshBreakdownTable();
+}
+
+void MainWindow::on_passengerSearchEdit_textChanged(const QString& text)
+{
+    Q_UNUSED(text);
+    passengerSearchTimer->start();
+}
+
+void MainWindow::on_tabWidget_currentChanged(int index)
+{
+    Q_UNUSED(index);
+    refreshVisibleTables();
+}
+
 void MainWindow::on_openBDButton_clicked()
 {
     QString fileName = QFileDialog::getOpenFileName(this, "Открыть базу данных", "", "Текстовые файлы (*.txt);;Все файлы (*.*)");
@@ -859,7 +979,6 @@ void MainWindow::on_openBDButton_clicked()
     }
 
     if (station.loadFromFile(fileName.toStdString(), nullptr, false, false)) {
-        refreshAllTables();
         wasSaved = true;
         showStatusMessage("База данных загружена из файла: " + fileName);
     } else {
@@ -894,19 +1013,31 @@ void MainWindow::on_checkBoxAutosave_checkStateChanged(const Qt::CheckState &arg
             askToSave("Данные были изменены.\nВместо них будут загружены данные из бэкапа.\nХотите сохранить изменения в отдельный файл?", true);
         }
         autoMode = true;
-        if (station.loadFromFile("data.backup", nullptr, true, false)) {
-            refreshAllTables();
+        std::uint64_t journalSeq;
+        if (station.loadFromFile("data.backup", nullptr, true, false, &journalSeq)) {
+            // Операции после последнего снимка восстанавливаются из журнала
+            journal.replay("data.journal", journalSeq);
             showStatusMessage("Бэкап успешно загружен, автосохранение включено");
-            station.saveToFile("data.backup", true, true);
         } else {
             showStatusMessage("Бэкап не обнаружен, автосохранение включено");
         }
+        // Без журнала операции не сохранялись бы: автосохранение не включается
+        if (!journal.open("data.journal")) {
+            autoMode = false;
+            QSignalBlocker blocker(ui->checkBoxAutosave);
+            ui->checkBoxAutosave->setChecked(false);
+            QMessageBox::warning(this, "Ошибка", "Не удалось открыть журнал операций, автосохранение выключено");
+            return;
+        }
+        backupWriter->start();
     } else
     {
-        station.saveToFile("data.backup", false, true);
-        wasSaved = true;
+        // Снимок с отключенным автосохранением берется сразу, записывается в фоне
         autoMode = false;
-        showStatusMessage("Бэкап сохранён, автосохранение выключено");
+        backupWriter->start();
+        journal.close();
+        wasSaved = true;
+        showStatusMessage("Бэкап сохраняется, автосохранение выключено");
     }
 }
 
@@ -919,7 +1050,6 @@ void MainWindow::on_restoreDataButtons_clicked(QAbstractButton *button)
             if (ui->checkBoxAutosave->isChecked()) ui->checkBoxAutosave->setChecked(false);
             station.clearAllData();
             discountManager.clearCustomDiscounts();
-            refreshAllTables();
         }
     }
 
@@ -927,7 +1057,6 @@ void MainWindow::on_restoreDataButtons_clicked(QAbstractButton *button)
         QMessageBox::StandardButton reply = QMessageBox::question(this, "Restore data", "Удалить бэкап и очистить данные в текущей сессии?\nПосле удаления бекап восстановить НЕВОЗМОЖНО", QMessageBox::Yes | QMessageBox::No);
         if (reply == QMessageBox::Yes){
             station.clearAllData();
-            refreshAllTables();
             if (ui->checkBoxAutosave->isChecked()) ui->checkBoxAutosave->setChecked(false);
         }
     }
@@ -9,7 +9,13 @@
 #include "deldialog.h"
 #include "core/station.h"
 #include "core/discount.h"
+#include "core/statistics.h"
+#include "core/journal.h"
+#include "stationmodels.h"
+#include "backupwriter.h"
 #include <QSortFilterProxyModel>
+#include <QTableView>
+#include <QTimer>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -40,31 +46,65 @@ private slots:
     void onAddingDialogAccepted(int mode, QString selfindex, const QVariantMap& data);
     void onEditDialogAccepted(int mode, QString selfindex, const QVariantMap& data);
 
-    void onDelDialogAccepted(int mode, int selectedIndex);
+    void onDelDialogAccepted(int mode, const QVariant& selected);
 
     void on_checkBoxAutosave_checkStateChanged(const Qt::CheckState &arg1);
 
     void on_restoreDataButtons_clicked(QAbstractButton *button);
 
     void on_totalRevenueButton_clicked();
+    void on_breakdownCombo_currentIndexChanged(int index);
+    void on_passengerSearchEdit_textChanged(const QString& text);
+    void on_tabWidget_currentChanged(int index);
 
 private:
     Ui::MainWindow *ui;
     Station station;
     DiscountManager discountManager;
+    StatisticsEngine statisticsEngine;
     bool autoMode;
     bool wasSaved;
 
+    // Таблицы окна (флаги для наборов таблиц)
+    typedef enum {
+        TABLE_TARIFFS = 1,
+        TABLE_DISCOUNTS = 2,
+        TABLE_PASSENGERS = 4,
+        TABLE_TICKETS = 8,
+        TABLE_BREAKDOWN = 16
+    } TableFlag;
+
+    // Действия, отложенные до конца текущего прохода цикла событий,
+    // чтобы несколько изменений подряд обрабатывались один раз.
+    // dirtyTables - таблицы, которые перестраиваются целиком при показе их вкладки,
+    // resizeTables - таблицы, ширина столбцов которых пересчитывается при показе
+    bool pendingWorkScheduled = false;
+    unsigned dirtyTables = 0;
+    unsigned resizeTables = 0;
+
+    // Автосохранение: каждая операция дописывается в журнал data.journal,
+    // снимок data.backup переписывается в фоне после накопления
+    // JOURNAL_COMPACTION_RECORDS записей (или сразу после сброса данных)
+    Journal journal;
+    BackupWriter* backupWriter;
+    std::uint64_t snapshotSeq = 0;
+    static const size_t JOURNAL_COMPACTION_RECORDS = 1000;
+
+    // Размер порции строк, загружаемых в таблицы пассажиров и билетов
+    static const int FETCH_BATCH_SIZE = 1000;
+
     // Модели для таблиц
-    QStandardItemModel *tariffsModel;
-    QStandardItemModel *discountsModel;
-    QStandardItemModel *passengersModel;
-    QStandardItemModel *ticketsModel;
+    TariffTableModel *tariffsModel;
+    DiscountTableModel *discountsModel;
+    PassengerTableModel *passengersModel;
+    TicketTableModel *ticketsModel;
+    QStandardItemModel *breakdownModel;
+
+    QSortFilterProxyModel* breakdownProxyModel;
 
-    QSortFilterProxyModel* tariffsProxyModel;
-    QSortFilterProxyModel* discountsProxyModel;
-    QSortFilterProxyModel* passesProxyModel;
-    QSortFilterProxyModel* ticketsProxyModel;
+    // Поиск пассажиров выполняется после паузы в наборе текста
+    QTimer* passengerSearchTimer;
+    static const int PASSENGER_SEARCH_DELAY_MS = 250;
 
     // Методы инициализации
     void setupModels();
@@ -76,19 +116,33 @@ private:
     void refreshDiscountsTable();
     void refreshPassengersTable();
     void refreshTicketsTable();
+    void refreshBreakdownTable();
     void refreshAllTables();
+    void refreshVisibleTables();
+    void resizeColumnsBySample(QTableView* view, const StationTableModel* model);
+
+    // Учет устаревших таблиц
+    unsigned visibleTables() const;
+    StationTableModel* tableModel(TableFlag table) const;
+    void invalidateTable(TableFlag table);
+    void markTableClean(TableFlag table);
+
+    // Обработка уведомлений об изменении данных
+    void onDataChanged(const ChangeEvent& event);
+    void schedulePendingWork();
+    void flushPendingWork();
 
     // Вспомогательные методы
     void showStatusMessage(const QString& message, int timeout = 3000);
     bool validatePassport(const QString& passportStr, int& passport) const;
-    bool validatePrice(const QString& priceStr, float& price) const;
+    bool validatePrice(const QString& priceStr, Money& price) const;
     bool validatePerc(float perc) const;
 
 
     // Получение данных из таблиц
-    QString getSelectedTariffName() const;
-    int getSelectedPassengerPassport() const;
-    int getSelectedTicketIndex() const;
+    Tariff* getSelectedTariff() const;
+    Passenger* getSelectedPassenger() const;
+    TicketId getSelectedTicketId() const;
 
     // Методы для работы с данными
     bool addPassenger(const QVariantMap& data);
@@ -98,7 +152,7 @@ private:
 
     bool deletePassenger(int passport);
     bool deleteTariff(const QString& name);
-    bool deleteTicket(int index);
+    bool deleteTicket(TicketId id);
     bool deleteDiscount(const QString& name);
 
     bool askToSave(const QString& message, bool noCancel);
@@ -0,0 +1,269 @@
+#include "pickermodel.h"
+#include <QCompleter>
+#include <QLineEdit>
+#include <QListView>
+#include <algorithm>
+#include <unordered_set>
+
+PickerModel::PickerModel(Kind kind, Station* station, QObject* parent)
+    : QAbstractListModel(parent)
+    , kind(kind)
+    , station(station)
+{
+}
+
+int PickerModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    switch (kind) {
+    case PASSENGERS: return static_cast<int>(station->getPassengerCount());
+    case TARIFFS:    return static_cast<int>(station->getTariffCount());
+    case TICKETS:    return static_cast<int>(station->getTicketCount());
+    }
+    return 0;
+}
+
+QVariant PickerModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        return displayText(index.row());
+    }
+
+    if (role == Qt::UserRole) {
+        if (kind == TICKETS) {
+            return static_cast<qulonglong>(station->getTicketAt(index.row())->getId());
+        }
+        return index.row();
+    }
+
+    return QVariant();
+}
+
+PickerModel::Kind PickerModel::getKind() const
+{
+    return kind;
+}
+
+Station* PickerModel::getStation() const
+{
+    return station;
+}
+
+QString PickerModel::displayText(int row) const
+{
+    switch (kind) {
+    case PASSENGERS: {
+        Passenger* passenger = station->getPassengerAt(row);
+        return QString("%1 %2 (паспорт: %3)")
+            .arg(QString::fromStdString(passenger->getLastName()))
+            .arg(QString::fromStdString(passenger->getFirstName()))
+            .arg(passenger->getPassport());
+    }
+    case TARIFFS: {
+        Tariff* tariff = station->getTariffAt(row);
+        return QString("%1 - %2 руб.")
+            .arg(QString::fromStdString(tariff->getName()))
+            .arg(QString::fromStdString(tariff->calculatePrice(false).toString()));
+    }
+    case TICKETS: {
+        Ticket* ticket = station->getTicketAt(row);
+        return QString("%1 -> %2 - %3 руб.")
+            .arg(QString::fromStdString(ticket->getPassenger()->getFullName()))
+            .arg(QString::fromStdString(ticket->getDestination()))
+            .arg(QString::fromStdString(ticket->getPrice(false).toString()));
+    }
+    }
+    return QString();
+}
+
+void PickerModel::setupComboBox(QComboBox* combo, Kind kind, Station* station)
+{
+    PickerModel* allModel = new PickerModel(kind, station, combo);
+    PickerSearchModel* searchModel = new PickerSearchModel(allModel, combo);
+
+    combo->setModel(allModel);
+
+    // Размер списка задается фиксированно, без обхода всех строк
+    combo->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    combo->setMinimumContentsLength(30);
+    if (QListView* view = qobject_cast<QListView*>(combo->view())) {
+        view->setUniformItemSizes(true);
+    }
+
+    combo->setEditable(true);
+    combo->setInsertPolicy(QComboBox::NoInsert);
+
+    // Подсказки строятся по индексам станции, сам QCompleter строки не фильтрует.
+    // Выбранная подсказка переводится в строку списка через mapToSource()
+    QCompleter* completer = new QCompleter(searchModel, combo);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    combo->setCompleter(completer);
+
+    connect(combo->lineEdit(), &QLineEdit::textEdited, searchModel,
+            [searchModel, completer](const QString& text) {
+                searchModel->setFilter(text);
+                completer->complete();
+            });
+
+    // Enter в поле ввода обрабатывается здесь: QComboBox искал бы введенный
+    // текст через findText(), форматируя все строки списка
+    disconnect(combo->lineEdit(), &QLineEdit::returnPressed, combo, nullptr);
+    connect(combo->lineEdit(), &QLineEdit::returnPressed, combo,
+            [combo]() { resolveSelection(combo); });
+}
+
+int PickerModel::resolveSelection(QComboBox* combo)
+{
+    PickerSearchModel* searchModel = combo->completer()
+        ? qobject_cast<PickerSearchModel*>(combo->completer()->model()) : nullptr;
+    if (!searchModel) {
+        return combo->currentIndex();
+    }
+
+    int row = searchModel->resolve(combo->currentText(), combo->currentIndex());
+    if (row >= 0 && row != combo->currentIndex()) {
+        combo->setCurrentIndex(row);
+    }
+    return row;
+}
+
+PickerSearchModel::PickerSearchModel(PickerModel* source, QObject* parent)
+    : QAbstractProxyModel(parent)
+    , picker(source)
+{
+    setSourceModel(source);
+}
+
+QModelIndex PickerSearchModel::index(int row, int column, const QModelIndex& parent) const
+{
+    if (parent.isValid() || column != 0 || row < 0 || row >= rowCount()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column);
+}
+
+QModelIndex PickerSearchModel::parent(const QModelIndex& child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+int PickerSearchModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(matches.size());
+}
+
+int PickerSearchModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : 1;
+}
+
+QModelIndex PickerSearchModel::mapToSource(const QModelIndex& proxyIndex) const
+{
+    if (!proxyIndex.isValid() || proxyIndex.row() >= rowCount()) {
+        return QModelIndex();
+    }
+    return picker->index(matches[proxyIndex.row()], 0);
+}
+
+// Результатов не больше MAX_MATCHES, поэтому обратный поиск - простым перебором
+QModelIndex PickerSearchModel::mapFromSource(const QModelIndex& sourceIndex) const
+{
+    if (!sourceIndex.isValid()) {
+        return QModelIndex();
+    }
+    auto it = std::find(matches.begin(), matches.end(), sourceIndex.row());
+    if (it == matches.end()) {
+        return QModelIndex();
+    }
+    return index(static_cast<int>(it - matches.begin()), 0);
+}
+
+// Пассажиры по номеру паспорта или по "Фамилия Имя" (сначала по началу, затем по подстроке)
+std::vector<Passenger*> PickerSearchModel::findPassengers(const std::string& query) const
+{
+    Station* station = picker->getStation();
+
+    bool isNumber = std::all_of(query.begin(), query.end(), [](char c) { return c >= '0' && c <= '9'; });
+    if (isNumber && query.size() <= 9) {
+        if (Passenger* passenger = station->findPassengerByPassport(std::stoi(query))) {
+            return {passenger};
+        }
+        return {};
+    }
+
+    std::vector<Passenger*> result = station->findPassengersByNamePrefix(query, MAX_MATCHES);
+    std::unordered_set<const Passenger*> found(result.begin(), result.end());
+    for (Passenger* passenger : station->findPassengersByNameSubstring(query, MAX_MATCHES)) {
+        if (result.size() >= MAX_MATCHES) break;
+        if (!found.count(passenger)) {
+            result.push_back(passenger);
+        }
+    }
+    return result;
+}
+
+// Текст выбранной строки не ищется заново; иначе подходит единственная
+// найденная запись или запись с точно таким же текстом
+int PickerSearchModel::resolve(const QString& text, int current)
+{
+    QString typed = text.trimmed();
+    if (typed.isEmpty()) {
+        return -1;
+    }
+    if (current >= 0 && picker->index(current, 0).data().toString() == typed) {
+        return current;
+    }
+
+    setFilter(typed);
+    if (matches.size() == 1) {
+        return matches.front();
+    }
+    for (int row : matches) {
+        if (picker->index(row, 0).data().toString() == typed) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+void PickerSearchModel::setFilter(const QString& text)
+{
+    beginResetModel();
+    matches.clear();
+
+    Station* station = picker->getStation();
+    std::string query = text.trimmed().toStdString();
+
+    if (!query.empty()) {
+        switch (picker->getKind()) {
+        case PickerModel::PASSENGERS:
+            for (Passenger* passenger : findPassengers(query)) {
+                matches.push_back(station->getPassengerRow(passenger));
+            }
+            break;
+        case PickerModel::TARIFFS:
+            for (Tariff* tariff : station->findTariffsByName(query, MAX_MATCHES)) {
+                matches.push_back(station->getTariffRow(tariff));
+            }
+            break;
+        case PickerModel::TICKETS:
+            for (Passenger* passenger : findPassengers(query)) {
+                for (Ticket* ticket : station->getTicketsByPassport(passenger->getPassport())) {
+                    if (matches.size() >= MAX_MATCHES) break;
+                    matches.push_back(station->getTicketRow(ticket->getId()));
+                }
+            }
+            break;
+        }
+    }
+
+    endResetModel();
+}
@@ -0,0 +1,80 @@
+#ifndef PICKERMODEL_H
+#define PICKERMODEL_H
+
+#include <QAbstractListModel>
+#include <QAbstractProxyModel>
+#include <QComboBox>
+#include <vector>
+#include "core/station.h"
+
+// Ленивая модель списка пассажиров, тарифов или билетов для выпадающих списков.
+// Текст строки форматируется только при запросе данных (т.е. для видимых строк),
+// поэтому открытие списка не зависит от размера реестра.
+// Строки совпадают с порядком записей станции.
+// Qt::UserRole: позиция записи в станции (для билетов - TicketId).
+class PickerModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    typedef enum {PASSENGERS, TARIFFS, TICKETS} Kind;
+
+    PickerModel(Kind kind, Station* station, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    Kind getKind() const;
+    Station* getStation() const;
+
+    // Настройка выпадающего списка: полный ленивый список и поиск с подсказками
+    static void setupComboBox(QComboBox* combo, Kind kind, Station* station);
+
+    // Строка списка, соответствующая введенному тексту, становится текущей;
+    // -1, если текст не совпадает ни с одной записью или совпадает с несколькими
+    static int resolveSelection(QComboBox* combo);
+
+private:
+    Kind kind;
+    Station* station;
+
+    QString displayText(int row) const;
+};
+
+// Результаты поиска поверх полного списка PickerModel: строки - найденные по
+// индексам станции записи (не более MAX_MATCHES). Как прокси над моделью
+// выпадающего списка, она позволяет QComboBox выбрать подсказку по позиции
+// строки, без поиска ее текста по всему списку.
+class PickerSearchModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    static const size_t MAX_MATCHES = 100;
+
+    explicit PickerSearchModel(PickerModel* source, QObject* parent = nullptr);
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+
+    // Поиск записей по тексту; пустой текст очищает результаты
+    void setFilter(const QString& text);
+
+    // Строка полного списка для введенного текста (см. PickerModel::resolveSelection)
+    int resolve(const QString& text, int current);
+
+private:
+    PickerModel* picker;
+
+    // Строки полного списка, найденные поиском
+    std::vector<int> matches;
+
+    std::vector<Passenger*> findPassengers(const std::string& query) const;
+};
+
+#endif // PICKERMODEL_H
@@ -0,0 +1,828 @@
+#include "stationmodels.h"
+#include "core/passenger.h"
+#include "core/tariff.h"
+#include "core/ticket.h"
+#include "core/radixsort.h"
+#include <QTimer>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <unordered_set>
+
+namespace {
+
+// Таблицы меньшего размера сортируются сразу в GUI-потоке
+const int BACKGROUND_SORT_ROWS = 10000;
+
+// Число устаревших результатов фоновой сортировки подряд, после которого
+// сортировка выполняется в GUI-потоке
+const int MAX_STALE_SORTS = 3;
+
+QString moneyText(Money value)
+{
+    return QString::fromStdString(value.toString());
+}
+
+// Устойчивая сортировка индексов по тексту без учета регистра; строки
+// переводятся в QString здесь же, в фоновом потоке
+std::vector<std::uint32_t> textSortPermutation(const std::vector<std::string>& texts, bool descending)
+{
+    std::vector<QString> keys(texts.size());
+    for (size_t i = 0; i < texts.size(); ++i) {
+        keys[i] = QString::fromStdString(texts[i]);
+    }
+
+    std::vector<std::uint32_t> index(keys.size());
+    std::iota(index.begin(), index.end(), 0);
+    std::stable_sort(index.begin(), index.end(), [&keys, descending](std::uint32_t a, std::uint32_t b) {
+        int result = QString::compare(keys[a], keys[b], Qt::CaseInsensitive);
+        return descending ? result > 0 : result < 0;
+    });
+    return index;
+}
+
+} // namespace
+
+StationTableModel::StationTableModel(EntityKind entity, const QStringList& headers, QObject* parent)
+    : QAbstractTableModel(parent)
+    , entity(entity)
+    , headers(headers)
+    , sortWatcher(new QFutureWatcher<std::vector<std::uint32_t>>(this))
+{
+    connect(sortWatcher, &QFutureWatcher<std::vector<std::uint32_t>>::finished,
+            this, &StationTableModel::onSortFinished);
+}
+
+int StationTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : fetched;
+}
+
+int StationTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(headers.size());
+}
+
+QVariant StationTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= fetched) {
+        return QVariant();
+    }
+    return cellData(recordAt(index.row()), index.column(), role);
+}
+
+QVariant StationTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Horizontal) {
+        return section < headers.size() ? headers[section] : QVariant();
+    }
+    return section + 1;
+}
+
+bool StationTableModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && fetched < rows;
+}
+
+void StationTableModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid() || fetched >= rows) {
+        return;
+    }
+
+    int count = std::min(fetchBatchSize, rows - fetched);
+    beginInsertRows(QModelIndex(), fetched, fetched + count - 1);
+    fetched += count;
+    endInsertRows();
+}
+
+void StationTableModel::setFetchBatchSize(int size)
+{
+    fetchBatchSize = size;
+    reload();
+}
+
+int StationTableModel::totalRowCount() const
+{
+    return rows;
+}
+
+void StationTableModel::reload()
+{
+    beginResetModel();
+    update();
+    rows = sourceRowCount();
+    fetched = fetchBatchSize > 0 ? std::min(rows, fetchBatchSize) : rows;
+    if (sortColumn >= 0) {
+        order.resize(rows);
+        std::iota(order.begin(), order.end(), 0);
+        rebuildPositions();
+        ++sortGeneration;
+    }
+    endResetModel();
+
+    if (sortColumn >= 0) {
+        startSort();
+    }
+}
+
+void StationTableModel::detach()
+{
+    beginResetModel();
+    rows = 0;
+    fetched = 0;
+    order.clear();
+    position.clear();
+    ++sortGeneration;
+    endResetModel();
+}
+
+void StationTableModel::applyChange(const ChangeEvent& event)
+{
+    if (event.entity != entity) {
+        dependencyChanged(event);
+        return;
+    }
+
+    int record = static_cast<int>(event.row);
+    switch (event.type) {
+    case CHANGE_INSERTED:
+        recordInserted(record);
+        break;
+    case CHANGE_UPDATED:
+        recordChanged(record);
+        break;
+    case CHANGE_REMOVED:
+        recordRemoved(record);
+        break;
+    case CHANGE_RESET:
+        reload();
+        break;
+    }
+}
+
+bool StationTableModel::dependsOn(EntityKind kind) const
+{
+    return kind == entity;
+}
+
+int StationTableModel::recordAt(int row) const
+{
+    return sortColumn >= 0 ? static_cast<int>(order[row]) : row;
+}
+
+bool StationTableModel::sortKey(int record, int column, std::int64_t& key) const
+{
+    Q_UNUSED(record);
+    Q_UNUSED(column);
+    Q_UNUSED(key);
+    return false;
+}
+
+std::string StationTableModel::sortText(int record, int column) const
+{
+    return cellData(record, column, Qt::DisplayRole).toString().toStdString();
+}
+
+// Следующие записи источника сдвигаются; при сортировке новая запись
+// встает на свое место двоичным поиском
+void StationTableModel::recordInserted(int record)
+{
+    if (sortColumn < 0) {
+        insertRowAt(record);
+        return;
+    }
+
+    ++sortGeneration;
+    // Номера записей после вставленной увеличиваются (при добавлении в конец - ни одна)
+    position.insert(position.begin() + record, 0);
+    for (size_t next = record + 1; next < position.size(); ++next) {
+        order[position[next]] = static_cast<std::uint32_t>(next);
+    }
+
+    size_t row = sortedPosition(order, record);
+    order.insert(order.begin() + row, record);
+    updatePositions(row, order.size());
+    insertRowAt(static_cast<int>(row));
+}
+
+void StationTableModel::recordRemoved(int record)
+{
+    if (sortColumn < 0) {
+        if (movesLastOnRemove) {
+            // На место удаленной записи встала последняя, последняя строка исчезает
+            removeRowAt(rows - 1);
+            if (record < rows) {
+                rowChanged(record);
+            }
+        } else {
+            removeRowAt(record);
+        }
+        return;
+    }
+
+    ++sortGeneration;
+    size_t row = position[record];
+    order.erase(order.begin() + row);
+    updatePositions(row, order.size());
+
+    if (movesLastOnRemove) {
+        // Последняя запись получает номер удаленной, ее строка не меняется
+        size_t last = position.size() - 1;
+        if (static_cast<size_t>(record) != last) {
+            position[record] = position[last];
+            order[position[record]] = static_cast<std::uint32_t>(record);
+        }
+        position.pop_back();
+    } else {
+        position.erase(position.begin() + record);
+        for (size_t next = record; next < position.size(); ++next) {
+            order[position[next]] = static_cast<std::uint32_t>(next);
+        }
+    }
+    removeRowAt(static_cast<int>(row));
+}
+
+void StationTableModel::recordChanged(int record)
+{
+    if (sortColumn < 0) {
+        rowChanged(record);
+        return;
+    }
+
+    ++sortGeneration;
+    // Остальные строки упорядочены, поэтому новое место ищется двоичным поиском
+    // только с той стороны, куда запись сместилась
+    size_t row = position[record];
+    size_t newRow = row;
+    auto less = [this](std::uint32_t entry, std::uint32_t value) { return recordLess(entry, value); };
+    if (row > 0 && recordLess(record, order[row - 1])) {
+        newRow = std::lower_bound(order.begin(), order.begin() + row, record, less) - order.begin();
+    } else if (row + 1 < order.size() && recordLess(order[row + 1], record)) {
+        newRow = std::lower_bound(order.begin() + row + 1, order.end(), record, less) - order.begin() - 1;
+    }
+    if (newRow != row) {
+        moveRowTo(row, newRow);
+    }
+    rowChanged(static_cast<int>(newRow));
+}
+
+// Новая строка показывается сразу, если попадает в загруженную часть
+// или все строки уже загружены; иначе она будет получена через fetchMore()
+void StationTableModel::insertRowAt(int row)
+{
+    if (row < fetched || fetched == rows) {
+        beginInsertRows(QModelIndex(), row, row);
+        ++rows;
+        ++fetched;
+        endInsertRows();
+    } else {
+        ++rows;
+    }
+}
+
+void StationTableModel::removeRowAt(int row)
+{
+    if (row < fetched) {
+        beginRemoveRows(QModelIndex(), row, row);
+        --rows;
+        --fetched;
+        endRemoveRows();
+    } else {
+        --rows;
+    }
+}
+
+// Перенос строки from на место to; затрагиваются только строки между ними
+void StationTableModel::moveRowTo(size_t from, size_t to)
+{
+    int first = static_cast<int>(from);
+    int last = static_cast<int>(to);
+    bool fromLoaded = first < fetched;
+    bool toLoaded = last < fetched;
+
+    if (fromLoaded && toLoaded) {
+        beginMoveRows(QModelIndex(), first, first, QModelIndex(), last > first ? last + 1 : last);
+    } else if (fromLoaded) {
+        // Строка уходит в незагруженную часть и будет получена через fetchMore()
+        beginRemoveRows(QModelIndex(), first, first);
+    } else if (toLoaded) {
+        beginInsertRows(QModelIndex(), last, last);
+    }
+
+    if (from < to) {
+        std::rotate(order.begin() + from, order.begin() + from + 1, order.begin() + to + 1);
+        updatePositions(from, to + 1);
+    } else {
+        std::rotate(order.begin() + to, order.begin() + from, order.begin() + from + 1);
+        updatePositions(to, from + 1);
+    }
+
+    if (fromLoaded && toLoaded) {
+        endMoveRows();
+    } else if (fromLoaded) {
+        --fetched;
+        endRemoveRows();
+    } else if (toLoaded) {
+        ++fetched;
+        endInsertRows();
+    }
+}
+
+void StationTableModel::rowChanged(int row)
+{
+    if (row < fetched) {
+        emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+    }
+}
+
+// Столбцы, зависящие от других записей, меняются целиком; представление
+// запрашивает заново только видимые ячейки
+void StationTableModel::columnsChanged(int first, int last)
+{
+    if (fetched > 0) {
+        emit dataChanged(index(0, first), index(fetched - 1, last));
+    }
+    if (sortColumn >= first && sortColumn <= last) {
+        ++sortGeneration;
+        scheduleSort();
+    }
+}
+
+void StationTableModel::sort(int column, Qt::SortOrder newOrder)
+{
+    if (column < 0 || column >= columnCount()) {
+        if (sortColumn >= 0) {
+            std::vector<std::uint32_t> identity(rows);
+            std::iota(identity.begin(), identity.end(), 0);
+            setOrder(std::move(identity));
+            sortColumn = -1;
+            order.clear();
+            position.clear();
+        }
+        return;
+    }
+
+    if (sortColumn < 0) {
+        order.resize(rows);
+        std::iota(order.begin(), order.end(), 0);
+        rebuildPositions();
+    }
+    sortColumn = column;
+    sortOrder = newOrder;
+    ++sortGeneration;
+    startSort();
+}
+
+// Сравнение записей по столбцу сортировки; равные ключи - по номеру записи,
+// как и при устойчивой сортировке всего столбца
+bool StationTableModel::recordLess(std::uint32_t a, std::uint32_t b) const
+{
+    bool descending = sortOrder == Qt::DescendingOrder;
+    std::int64_t keyA, keyB;
+    if (sortKey(a, sortColumn, keyA) && sortKey(b, sortColumn, keyB)) {
+        if (keyA != keyB) {
+            return descending ? keyA > keyB : keyA < keyB;
+        }
+    } else {
+        int result = QString::compare(QString::fromStdString(sortText(a, sortColumn)),
+                                      QString::fromStdString(sortText(b, sortColumn)),
+                                      Qt::CaseInsensitive);
+        if (result != 0) {
+            return descending ? result > 0 : result < 0;
+        }
+    }
+    return a < b;
+}
+
+size_t StationTableModel::sortedPosition(const std::vector<std::uint32_t>& sorted, std::uint32_t record) const
+{
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), record,
+                               [this](std::uint32_t entry, std::uint32_t value) {
+                                   return recordLess(entry, value);
+                               });
+    return it - sorted.begin();
+}
+
+void StationTableModel::rebuildPositions()
+{
+    position.resize(order.size());
+    updatePositions(0, order.size());
+}
+
+void StationTableModel::updatePositions(size_t first, size_t last)
+{
+    for (size_t row = first; row < last; ++row) {
+        position[order[row]] = static_cast<std::uint32_t>(row);
+    }
+}
+
+// Замена порядка строк с переносом выделения и текущей строки представления
+void StationTableModel::setOrder(std::vector<std::uint32_t> newOrder)
+{
+    emit layoutAboutToBeChanged();
+
+    std::vector<std::uint32_t> oldOrder = std::move(order);
+    order = std::move(newOrder);
+    rebuildPositions();
+
+    QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex& index : from) {
+        std::uint32_t record = oldOrder.empty() ? index.row() : oldOrder[index.row()];
+        int row = static_cast<int>(position[record]);
+        to.append(row < fetched ? this->index(row, index.column()) : QModelIndex());
+    }
+    changePersistentIndexList(from, to);
+
+    emit layoutChanged();
+}
+
+void StationTableModel::scheduleSort()
+{
+    if (sortScheduled) return;
+    sortScheduled = true;
+    QTimer::singleShot(0, this, [this]() { startSort(); });
+}
+
+// Значения записей копируются здесь (записи станции меняются только в GUI-потоке):
+// целые ключи или строки источника без форматирования. Текст для сравнения
+// и перестановка строятся в фоновом потоке
+void StationTableModel::startSort()
+{
+    sortScheduled = false;
+    if (sortColumn < 0) {
+        return;
+    }
+
+    jobGeneration = sortGeneration;
+    bool descending = sortOrder == Qt::DescendingOrder;
+
+    std::function<std::vector<std::uint32_t>()> job;
+    std::int64_t probe;
+    if (rows > 0 && sortKey(0, sortColumn, probe)) {
+        std::vector<std::int64_t> keys(rows);
+        for (int record = 0; record < rows; ++record) {
+            sortKey(record, sortColumn, keys[record]);
+        }
+        job = [keys = std::move(keys), descending]() {
+            return radixSortPermutation(keys, descending);
+        };
+    } else {
+        std::vector<std::string> keys(rows);
+        for (int record = 0; record < rows; ++record) {
+            keys[record] = sortText(record, sortColumn);
+        }
+        job = [keys = std::move(keys), descending]() {
+            return textSortPermutation(keys, descending);
+        };
+    }
+
+    if (rows < BACKGROUND_SORT_ROWS || staleSorts >= MAX_STALE_SORTS) {
+        staleSorts = 0;
+        // Пустой (отмененный) future отвязывает наблюдателя от прежнего задания
+        sortWatcher->setFuture(QFuture<std::vector<std::uint32_t>>());
+        setOrder(job());
+        return;
+    }
+    sortWatcher->setFuture(QtConcurrent::run(std::move(job)));
+}
+
+void StationTableModel::onSortFinished()
+{
+    if (sortColumn < 0 || sortWatcher->isCanceled()) {
+        return;
+    }
+    if (jobGeneration != sortGeneration) {
+        ++staleSorts;
+        scheduleSort();
+        return;
+    }
+    staleSorts = 0;
+    setOrder(sortWatcher->result());
+}
+
+// Тарифы
+
+TariffTableModel::TariffTableModel(Station* station, QObject* parent)
+    : StationTableModel(ENTITY_TARIFF, {"Название", "Тип вагона", "Базовая цена", "Скидка", "Итоговая цена"}, parent)
+    , station(station)
+{
+}
+
+int TariffTableModel::sourceRowCount() const
+{
+    return static_cast<int>(station->getTariffCount());
+}
+
+Tariff* TariffTableModel::tariffAt(int row) const
+{
+    return station->getAllTariffs()[recordAt(row)];
+}
+
+bool TariffTableModel::sortKey(int record, int column, std::int64_t& key) const
+{
+    const Tariff* tariff = station->getAllTariffs()[record];
+    switch (column) {
+    case 2: key = tariff->getBasePrice().getKopecks(); return true;
+    case 4: key = tariff->calculatePrice(false).getKopecks(); return true;
+    }
+    return false;
+}
+
+std::string TariffTableModel::sortText(int record, int column) const
+{
+    const Tariff* tariff = station->getAllTariffs()[record];
+    switch (column) {
+    case 0: return tariff->getName();
+    case 1: return tariff->getVagonTypeString();
+    }
+    return StationTableModel::sortText(record, column);
+}
+
+QVariant TariffTableModel::cellData(int record, int column, int role) const
+{
+    if (role != Qt::DisplayRole && role != Qt::EditRole) {
+        return QVariant();
+    }
+
+    const Tariff* tariff = station->getAllTariffs()[record];
+    bool display = role == Qt::DisplayRole;
+
+    switch (column) {
+    case 0:
+        return QString::fromStdString(tariff->getName());
+    case 1:
+        return QString::fromStdString(tariff->getVagonTypeString());
+    case 2: {
+        Money basePrice = tariff->getBasePrice();
+        return display ? QVariant(moneyText(basePrice)) : QVariant(basePrice.toRubles());
+    }
+    case 3: {
+        const DiscountInfo& discountInfo = tariff->getDiscountInfo();
+        return QString("%1 (%2%)")
+            .arg(QString::fromStdString(discountInfo.name))
+            .arg(discountInfo.percentage, 0, 'f', 1);
+    }
+    case 4: {
+        Money finalPrice = tariff->calculatePrice(false);
+        return display ? QVariant(moneyText(finalPrice)) : QVariant(finalPrice.toRubles());
+    }
+    }
+    return QVariant();
+}
+
+// Скидки
+
+DiscountTableModel::DiscountTableModel(DiscountManager* manager, QObject* parent)
+    : StationTableModel(ENTITY_DISCOUNT, {"Название", "Размер, %", "Описание"}, parent)
+    , manager(manager)
+{
+}
+
+int DiscountTableModel::sourceRowCount() const
+{
+    return static_cast<int>(manager->getDiscountCount());
+}
+
+DiscountHandle DiscountTableModel::discountAt(int row) const
+{
+    return manager->getDiscountByIndex(recordAt(row));
+}
+
+// Размер скидки в сотых долях процента
+bool DiscountTableModel::sortKey(int record, int column, std::int64_t& key) const
+{
+    if (column != 1) {
+        return false;
+    }
+    key = std::llround(manager->getDiscountByIndex(record)->getDiscountPercentage() * 100.0);
+    return true;
+}
+
+std::string DiscountTableModel::sortText(int record, int column) const
+{
+    DiscountHandle discount = manager->getDiscountByIndex(record);
+    const DiscountInfo& info = discount->getDiscountInfo();
+    switch (column) {
+    case 0: return info.name;
+    case 2: return info.description;
+    }
+    return StationTableModel::sortText(record, column);
+}
+
+QVariant DiscountTableModel::cellData(int record, int column, int role) const
+{
+    if (role != Qt::DisplayRole && role != Qt::EditRole) {
+        return QVariant();
+    }
+
+    DiscountHandle discount = manager->getDiscountByIndex(record);
+    const DiscountInfo& info = discount->getDiscountInfo();
+
+    switch (column) {
+    case 0:
+        return QString::fromStdString(info.name);
+    case 1: {
+        double perc = discount->getDiscountPercentage();
+        return role == Qt::DisplayRole ? QVariant(QString::number(perc, 'f', 2)) : QVariant(perc);
+    }
+    case 2:
+        return QString::fromStdString(info.description);
+    }
+    return QVariant();
+}
+
+// Пассажиры
+
+PassengerTableModel::PassengerTableModel(Station* station, QObject* parent)
+    : StationTableModel(ENTITY_PASSENGER, {"Паспорт", "Фамилия", "Имя"}, parent)
+    , station(station)
+{
+}
+
+int PassengerTableModel::sourceRowCount() const
+{
+    return static_cast<int>(query.empty() ? station->getPassengerCount() : matches.size());
+}
+
+Passenger* PassengerTableModel::passengerOf(int record) const
+{
+    return query.empty() ? station->getAllPassengers()[record] : matches[record];
+}
+
+Passenger* PassengerTableModel::passengerAt(int row) const
+{
+    return passengerOf(recordAt(row));
+}
+
+bool PassengerTableModel::sortKey(int record, int column, std::int64_t& key) const
+{
+    if (column != 0) {
+        return false;
+    }
+    key = passengerOf(record)->getPassport();
+    return true;
+}
+
+std::string PassengerTableModel::sortText(int record, int column) const
+{
+    const Passenger* passenger = passengerOf(record);
+    switch (column) {
+    case 1: return passenger->getLastName();
+    case 2: return passenger->getFirstName();
+    }
+    return StationTableModel::sortText(record, column);
+}
+
+void PassengerTableModel::setSearchText(const QString& text)
+{
+    QString trimmed = text.trimmed();
+    query = trimmed.toStdString();
+    substringSearch = trimmed.size() >= MIN_SUBSTRING_QUERY;
+    reload();
+}
+
+void PassengerTableModel::applyChange(const ChangeEvent& event)
+{
+    if (event.entity == ENTITY_PASSENGER && !query.empty()) {
+        reload();
+        return;
+    }
+    StationTableModel::applyChange(event);
+}
+
+void PassengerTableModel::update()
+{
+    matches.clear();
+    if (query.empty()) {
+        return;
+    }
+
+    matches = station->findPassengersByNamePrefix(query, MAX_SEARCH_RESULTS);
+    if (!substringSearch) {
+        return;
+    }
+    std::unordered_set<const Passenger*> found(matches.begin(), matches.end());
+    for (Passenger* passenger : station->findPassengersByNameSubstring(query, MAX_SEARCH_RESULTS)) {
+        if (matches.size() >= MAX_SEARCH_RESULTS) break;
+        if (!found.count(passenger)) {
+            matches.push_back(passenger);
+        }
+    }
+}
+
+QVariant PassengerTableModel::cellData(int record, int column, int role) const
+{
+    if (role != Qt::DisplayRole && role != Qt::EditRole) {
+        return QVariant();
+    }
+
+    const Passenger* passenger = passengerOf(record);
+
+    switch (column) {
+    case 0: {
+        int passport = passenger->getPassport();
+        return role == Qt::DisplayRole ? QVariant(QString::number(passport)) : QVariant(passport);
+    }
+    case 1:
+        return QString::fromStdString(passenger->getLastName());
+    case 2:
+        return QString::fromStdString(passenger->getFirstName());
+    }
+    return QVariant();
+}
+
+// Билеты
+
+TicketTableModel::TicketTableModel(Station* station, QObject* parent)
+    : StationTableModel(ENTITY_TICKET, {"Паспорт", "Пассажир", "Направление", "Стоимость"}, parent)
+    , station(station)
+{
+    movesLastOnRemove = true;
+}
+
+int TicketTableModel::sourceRowCount() const
+{
+    return static_cast<int>(station->getTicketCount());
+}
+
+// Паспорт и имя берутся у пассажира, направление и цена - у тарифа
+void TicketTableModel::dependencyChanged(const ChangeEvent& event)
+{
+    if (event.type != CHANGE_UPDATED) {
+        return;
+    }
+    if (event.entity == ENTITY_PASSENGER) {
+        columnsChanged(0, 1);
+    } else if (event.entity == ENTITY_TARIFF) {
+        columnsChanged(2, 3);
+    }
+}
+
+bool TicketTableModel::dependsOn(EntityKind kind) const
+{
+    return StationTableModel::dependsOn(kind) || kind == ENTITY_PASSENGER || kind == ENTITY_TARIFF;
+}
+
+Ticket* TicketTableModel::ticketAt(int row) const
+{
+    return station->getAllTickets()[recordAt(row)];
+}
+
+bool TicketTableModel::sortKey(int record, int column, std::int64_t& key) const
+{
+    const Ticket* ticket = station->getAllTickets()[record];
+    switch (column) {
+    case 0: key = ticket->getPassportNumber(); return true;
+    case 3: key = ticket->getPrice(false).getKopecks(); return true;
+    }
+    return false;
+}
+
+std::string TicketTableModel::sortText(int record, int column) const
+{
+    const Ticket* ticket = station->getAllTickets()[record];
+    switch (column) {
+    case 1: return ticket->getPassenger()->getFullName();
+    case 2: return ticket->getDestination();
+    }
+    return StationTableModel::sortText(record, column);
+}
+
+QVariant TicketTableModel::cellData(int record, int column, int role) const
+{
+    const Ticket* ticket = station->getAllTickets()[record];
+
+    if (role == Qt::UserRole) {
+        return static_cast<qulonglong>(ticket->getId());
+    }
+    if (role != Qt::DisplayRole && role != Qt::EditRole) {
+        return QVariant();
+    }
+
+    switch (column) {
+    case 0: {
+        int passport = ticket->getPassportNumber();
+        return role == Qt::DisplayRole ? QVariant(QString::number(passport)) : QVariant(passport);
+    }
+    case 1: {
+        const Passenger* passenger = ticket->getPassenger();
+        return QString::fromStdString(passenger->getLastName()) + ' ' +
+               QString::fromStdString(passenger->getFirstName());
+    }
+    case 2:
+        return QString::fromStdString(ticket->getDestination());
+    case 3: {
+        Money price = ticket->getPrice(false);
+        return role == Qt::DisplayRole ? QVariant(moneyText(price)) : QVariant(price.toRubles());
+    }
+    }
+    return QVariant();
+}
@@ -0,0 +1,246 @@
+#ifndef STATIONMODELS_H
+#define STATIONMODELS_H
+
+#include <QAbstractTableModel>
+#include <QFutureWatcher>
+#include <QStringList>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/station.h"
+#include "core/discount.h"
+
+// Табличные модели, читающие записи напрямую из Station и DiscountManager.
+// Строки не копируются в модель: текст ячейки формируется в data() только
+// при запросе (т.е. для видимых ячеек), поэтому обновление таблицы не зависит
+// от числа записей. Изменения отдельных записей передаются в applyChange()
+// из уведомлений станции и затрагивают только соответствующие строки.
+// При заданном размере порции строки отдаются представлению порциями
+// через canFetchMore()/fetchMore() по мере прокрутки.
+//
+// Сортировку выполняет сама модель (представление вызывает sort()): в GUI-потоке
+// копируются только значения столбца из записей источника, перестановка строится
+// в фоновом потоке (целочисленные столбцы - поразрядной сортировкой) и применяется
+// одним изменением раскладки. Пока сортировка включена, вставленная или измененная
+// запись ставится на место двоичным поиском, а номера строк пересчитываются
+// только для сдвинутых строк.
+//
+// Номер записи (record) - позиция в списке источника, номер строки (row) -
+// позиция в представлении с учетом сортировки.
+// Qt::DisplayRole - текст ячейки, Qt::EditRole - значение ячейки.
+class StationTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    StationTableModel(EntityKind entity, const QStringList& headers, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    // Сортировка по столбцу; column < 0 возвращает порядок источника
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // Размер порции загрузки строк (0 - все строки сразу), со сбросом модели
+    void setFetchBatchSize(int size);
+
+    // Число записей в источнике, включая еще не загруженные
+    int totalRowCount() const;
+
+    // Значение ячейки любой записи источника (в т.ч. не загруженной)
+    virtual QVariant cellData(int record, int column, int role) const = 0;
+
+    // Полный сброс модели
+    void reload();
+
+    // Сброс до пустой таблицы без обращения к источнику (для скрытой таблицы,
+    // которая будет перестроена через reload() при показе)
+    void detach();
+
+    // Обработка уведомления об изменении записи
+    virtual void applyChange(const ChangeEvent& event);
+
+    // Зависят ли строки модели от записей вида kind
+    virtual bool dependsOn(EntityKind kind) const;
+
+protected:
+    // Число записей в источнике
+    virtual int sourceRowCount() const = 0;
+
+    // Пересчет состояния модели внутри сброса
+    virtual void update() {}
+
+    // Изменение записей другого вида, от которых зависят столбцы модели
+    virtual void dependencyChanged(const ChangeEvent& event) { Q_UNUSED(event); }
+
+    // Целочисленный ключ сортировки столбца; false - столбец сортируется как текст
+    virtual bool sortKey(int record, int column, std::int64_t& key) const;
+
+    // Текст записи для сортировки по текстовому столбцу, без перевода в QString;
+    // по умолчанию - текст ячейки
+    virtual std::string sortText(int record, int column) const;
+
+    // Запись, показанная в строке row
+    int recordAt(int row) const;
+
+    void columnsChanged(int first, int last);
+
+    // Удаление записи переносит последнюю запись на ее место (как у билетов станции)
+    bool movesLastOnRemove = false;
+
+private:
+    EntityKind entity;
+    QStringList headers;
+    int fetchBatchSize = 0;
+
+    // Число записей и число загруженных строк; меняются вместе с сигналами
+    // вставки и удаления
+    int rows = 0;
+    int fetched = 0;
+
+    // Строка -> запись и запись -> строка (только при sortColumn >= 0)
+    int sortColumn = -1;
+    Qt::SortOrder sortOrder = Qt::AscendingOrder;
+    std::vector<std::uint32_t> order;
+    std::vector<std::uint32_t> position;
+
+    // Фоновая сортировка. Поколение увеличивается при каждом изменении записей;
+    // результат, построенный по устаревшим ключам, отбрасывается. После
+    // MAX_STALE_SORTS отброшенных результатов подряд (непрерывные изменения)
+    // сортировка выполняется сразу в GUI-потоке
+    QFutureWatcher<std::vector<std::uint32_t>>* sortWatcher;
+    unsigned sortGeneration = 0;
+    unsigned jobGeneration = 0;
+    bool sortScheduled = false;
+    int staleSorts = 0;
+
+    void recordInserted(int record);
+    void recordRemoved(int record);
+    void recordChanged(int record);
+
+    void insertRowAt(int row);
+    void removeRowAt(int row);
+    void rowChanged(int row);
+    void moveRowTo(size_t from, size_t to);
+
+    bool recordLess(std::uint32_t a, std::uint32_t b) const;
+    size_t sortedPosition(const std::vector<std::uint32_t>& sorted, std::uint32_t record) const;
+    void rebuildPositions();
+    void updatePositions(size_t first, size_t last);
+    void setOrder(std::vector<std::uint32_t> newOrder);
+    void scheduleSort();
+    void startSort();
+    void onSortFinished();
+};
+
+class TariffTableModel : public StationTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit TariffTableModel(Station* station, QObject* parent = nullptr);
+
+    QVariant cellData(int record, int column, int role) const override;
+
+    Tariff* tariffAt(int row) const;
+
+protected:
+    int sourceRowCount() const override;
+    bool sortKey(int record, int column, std::int64_t& key) const override;
+    std::string sortText(int record, int column) const override;
+
+private:
+    Station* station;
+};
+
+class DiscountTableModel : public StationTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit DiscountTableModel(DiscountManager* manager, QObject* parent = nullptr);
+
+    QVariant cellData(int record, int column, int role) const override;
+
+    DiscountHandle discountAt(int row) const;
+
+protected:
+    int sourceRowCount() const override;
+    bool sortKey(int record, int column, std::int64_t& key) const override;
+    std::string sortText(int record, int column) const override;
+
+private:
+    DiscountManager* manager;
+};
+
+// Без строки поиска - все пассажиры станции, иначе совпадения по началу
+// "Фамилия Имя", затем остальные совпадения по подстроке (не более
+// MAX_SEARCH_RESULTS). Для строки короче MIN_SUBSTRING_QUERY символов
+// поиск по подстроке не выполняется: индексу не по чему ее искать
+class PassengerTableModel : public StationTableModel
+{
+    Q_OBJECT
+
+public:
+    static const size_t MAX_SEARCH_RESULTS = 1000;
+    static const int MIN_SUBSTRING_QUERY = 3;
+
+    explicit PassengerTableModel(Station* station, QObject* parent = nullptr);
+
+    QVariant cellData(int record, int column, int role) const override;
+
+    Passenger* passengerAt(int row) const;
+
+    // Установка строки поиска со сбросом модели
+    void setSearchText(const QString& text);
+
+    // При активном поиске изменение пассажиров повторяет поиск
+    void applyChange(const ChangeEvent& event) override;
+
+protected:
+    int sourceRowCount() const override;
+    bool sortKey(int record, int column, std::int64_t& key) const override;
+    std::string sortText(int record, int column) const override;
+    void update() override;
+
+private:
+    Station* station;
+    std::string query;
+    bool substringSearch = false;
+    std::vector<Passenger*> matches;
+
+    Passenger* passengerOf(int record) const;
+};
+
+// Qt::UserRole: TicketId билета строки
+class TicketTableModel : public StationTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit TicketTableModel(Station* station, QObject* parent = nullptr);
+
+    QVariant cellData(int record, int column, int role) const override;
+
+    Ticket* ticketAt(int row) const;
+
+    // Столбцы пассажира и тарифа читаются из связанных записей
+    bool dependsOn(EntityKind kind) const override;
+
+protected:
+    int sourceRowCount() const override;
+    bool sortKey(int record, int column, std::int64_t& key) const override;
+    std::string sortText(int record, int column) const override;
+    void dependencyChanged(const ChangeEvent& event) override;
+
+private:
+    Station* station;
+};
+
+#endif // STATIONMODELS_H